@@ -0,0 +1,132 @@
+#[=======================================================================[.rst:
+FindFFmpeg
+-------
+
+Finds the FFmpeg libraries used for built-in video capture.
+
+Imported Targets
+^^^^^^^^^^^^^^^^
+
+This module provides the following imported targets, if found:
+
+``FFmpeg::avformat``
+  The container muxing library
+``FFmpeg::avcodec``
+  The encoder library
+``FFmpeg::avutil``
+  The utility library
+``FFmpeg::swscale``
+  The pixel format conversion library
+``FFmpeg::swresample``
+  The audio resampling library
+
+Result Variables
+^^^^^^^^^^^^^^^^
+
+This will define the following variables:
+
+``FFmpeg_FOUND``
+  True if the system has all the requested components.
+``FFmpeg_<component>_FOUND``
+  True if the component (avformat, avcodec, avutil, swscale, swresample) is found
+
+Cache Variables
+^^^^^^^^^^^^^^^
+
+The following cache variables may also be set:
+
+``FFmpeg_<component>_INCLUDE_DIR``
+  The directory containing ``lib<component>/<component>.h``.
+``FFmpeg_<component>_DLL``
+  The path to the component's Windows runtime.
+``FFmpeg_<component>_LIBRARY``
+  The path to the component's library.
+
+#]=======================================================================]
+
+if(NOT FFmpeg_FIND_COMPONENTS)
+  set(FFmpeg_FIND_COMPONENTS avformat avcodec avutil swscale swresample)
+endif()
+
+find_package(PkgConfig QUIET)
+
+foreach(_component ${FFmpeg_FIND_COMPONENTS})
+  string(TOUPPER "${_component}" _upper_component)
+
+  pkg_check_modules(PC_${_upper_component} QUIET lib${_component})
+
+  find_path(
+    FFmpeg_${_component}_INCLUDE_DIR
+    NAMES lib${_component}/${_component}.h
+    HINTS "${PC_${_upper_component}_INCLUDEDIR}"
+  )
+
+  find_file(
+    FFmpeg_${_component}_DLL
+    NAMES ${_component}.dll
+          ${_component}-58.dll ${_component}-59.dll ${_component}-60.dll ${_component}-61.dll
+          ${_component}-5.dll ${_component}-6.dll ${_component}-7.dll ${_component}-8.dll
+    PATH_SUFFIXES bin
+    HINTS "${PC_${_upper_component}_PREFIX}"
+  )
+
+  find_library(
+    FFmpeg_${_component}_LIBRARY
+    NAMES ${_component}
+    HINTS "${PC_${_upper_component}_LIBDIR}"
+  )
+
+  if(FFmpeg_${_component}_DLL OR FFmpeg_${_component}_LIBRARY MATCHES ".so|.dylib")
+    set(_${_component}_library_type SHARED)
+  else()
+    set(_${_component}_library_type STATIC)
+  endif()
+
+  get_flags_from_pkg_config("${_${_component}_library_type}" "PC_${_upper_component}" "_${_component}")
+
+  if(FFmpeg_${_component}_LIBRARY AND FFmpeg_${_component}_INCLUDE_DIR)
+    set(FFmpeg_${_component}_FOUND "TRUE")
+  else()
+    set(FFmpeg_${_component}_FOUND "FALSE")
+  endif()
+
+  mark_as_advanced(
+    FFmpeg_${_component}_INCLUDE_DIR
+    FFmpeg_${_component}_DLL
+    FFmpeg_${_component}_LIBRARY
+  )
+endforeach()
+
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(
+  FFmpeg
+  REQUIRED_VARS "FFmpeg_avutil_LIBRARY"
+                "FFmpeg_avutil_INCLUDE_DIR"
+  HANDLE_COMPONENTS
+)
+
+foreach(_component ${FFmpeg_FIND_COMPONENTS})
+  if(FFmpeg_${_component}_FOUND AND NOT TARGET FFmpeg::${_component})
+    add_library(FFmpeg::${_component} ${_${_component}_library_type} IMPORTED)
+    set_target_properties(
+      FFmpeg::${_component}
+      PROPERTIES INTERFACE_INCLUDE_DIRECTORIES "${FFmpeg_${_component}_INCLUDE_DIR}"
+                 INTERFACE_COMPILE_OPTIONS "${_${_component}_compile_options}"
+                 INTERFACE_LINK_LIBRARIES "${_${_component}_link_libraries}"
+                 INTERFACE_LINK_DIRECTORIES "${_${_component}_link_directories}"
+                 INTERFACE_LINK_OPTIONS "${_${_component}_link_options}"
+    )
+    if(FFmpeg_${_component}_DLL)
+      set_target_properties(
+        FFmpeg::${_component}
+        PROPERTIES IMPORTED_LOCATION "${FFmpeg_${_component}_DLL}"
+                   IMPORTED_IMPLIB "${FFmpeg_${_component}_LIBRARY}"
+      )
+    else()
+      set_target_properties(
+        FFmpeg::${_component}
+        PROPERTIES IMPORTED_LOCATION "${FFmpeg_${_component}_LIBRARY}"
+      )
+    endif()
+  endif()
+endforeach()
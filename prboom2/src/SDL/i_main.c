@@ -74,6 +74,7 @@
 #include "dsda.h"
 #include "dsda/args.h"
 #include "dsda/analysis.h"
+#include "dsda/demo_batch.h"
 #include "dsda/args.h"
 #include "dsda/endoom.h"
 #include "dsda/settings.h"
@@ -179,6 +180,9 @@ void I_SafeExit(int rc)
 
   lprintf(LO_DEBUG, "\n"); // Separator after game loop
 
+  // Only returns outside of -playdemo_batch workers
+  dsda_ExitBatchWorker(rc);
+
   // Run through all exit functions
   for (; exit_priority < exit_priority_max; ++exit_priority)
   {
@@ -286,6 +290,9 @@ int main(int argc, char **argv)
   // Example: dsda-doom.exe -record mydemo -playdemo demoname
   ParamsMatchingCheck();
 
+  // Forces -nodraw and -nosound, must be before SDL is initialized
+  dsda_InitDemoBatch();
+
   // e6y: was moved from D_DoomMainSetup
   // init subsystems
   //jff 9/3/98 use logical output routine
@@ -37,6 +37,7 @@
 #endif
 
 #include <stdlib.h>
+#include <string.h>
 
 #include "SDL.h"
 
@@ -64,6 +65,11 @@ void I_UpdateRenderSize(void)
     renderW = gl_window_width;
     renderH = gl_window_height;
   }
+  else if (I_Headless())
+  {
+    renderW = SCREENWIDTH;
+    renderH = SCREENHEIGHT;
+  }
   else
   {
     SDL_GetRendererOutputSize(sdl_renderer, &renderW, &renderH);
@@ -118,6 +124,11 @@ unsigned char *I_GrabScreen(void)
     return gld_ReadScreen();
   }
 
+  if (I_Headless())
+  {
+    return I_GrabScreenIndexed(grab_format_rgb24, 1);
+  }
+
   size = renderW * renderH * 3;
   if (!pixels || size > pixels_size)
   {
@@ -133,3 +144,204 @@ unsigned char *I_GrabScreen(void)
 
   return pixels;
 }
+
+// Direct capture from the 8-bit software buffer
+// Converts screens[0] at the internal render resolution, without going
+// through the SDL renderer. Colour conversion is done once per palette
+// entry, so the per-pixel work is a single table lookup.
+// Frames can be enlarged by a whole factor on the way, each source pixel
+// becoming a scale x scale block, so a low internal resolution still gives
+// a full size video.
+
+// Tables are built per frame from the frame's own palette,
+// so frames can be converted on the capture writer thread
+typedef struct
+{
+  unsigned int rgb[256];
+  byte y[256];
+  byte u[256];
+  byte v[256];
+} grab_tables_t;
+
+static void I_UpdateGrabTables(grab_tables_t *tables, const SDL_Color *colors, grab_format_t format)
+{
+  int i;
+
+  for (i = 0; i < 256; i++)
+  {
+    int r = colors[i].r;
+    int g = colors[i].g;
+    int b = colors[i].b;
+
+    if (format == grab_format_rgb24)
+    {
+      // byte order in memory is r, g, b, (unused)
+      byte rgb[4] = { r, g, b, 0 };
+      memcpy(&tables->rgb[i], rgb, 4);
+    }
+    else
+    {
+      // BT.601, limited range
+      tables->y[i] = (( 66 * r + 129 * g +  25 * b + 128) >> 8) +  16;
+      tables->u[i] = ((-38 * r -  74 * g + 112 * b + 128) >> 8) + 128;
+      tables->v[i] = ((112 * r -  94 * g -  18 * b + 128) >> 8) + 128;
+    }
+  }
+}
+
+static void I_GrabRowRGB24(const grab_tables_t *tables, byte *dest, const byte *src, int width)
+{
+  int x;
+
+  // each pixel is stored as a 4 byte word and the next pixel overwrites
+  // the unused byte, so the last pixel has to be stored separately
+  for (x = 0; x < width - 1; x++, dest += 3)
+    memcpy(dest, &tables->rgb[src[x]], 4);
+
+  memcpy(dest, &tables->rgb[src[x]], 3);
+}
+
+static void I_GrabRowRGB24Scaled(const grab_tables_t *tables, byte *dest, const byte *src, int width, int scale)
+{
+  int x, i;
+
+  for (x = 0; x < width - 1; x++)
+    for (i = 0; i < scale; i++, dest += 3)
+      memcpy(dest, &tables->rgb[src[x]], 4);
+
+  for (i = 0; i < scale - 1; i++, dest += 3)
+    memcpy(dest, &tables->rgb[src[x]], 4);
+
+  memcpy(dest, &tables->rgb[src[x]], 3);
+}
+
+// Frame size is width * scale by height * scale
+static void I_GrabFrameYUV420(const grab_tables_t *tables, byte *dest, const byte *src, int pitch,
+                              int width, int height, int scale)
+{
+  int x, y;
+  int out_width = width * scale;
+  int out_height = height * scale;
+  int cw = (out_width + 1) >> 1;
+  int ch = (out_height + 1) >> 1;
+  byte *dest_y = dest;
+  byte *dest_u = dest_y + out_width * out_height;
+  byte *dest_v = dest_u + cw * ch;
+
+  for (y = 0; y < height; y++)
+  {
+    const byte *row = src + y * pitch;
+    byte *first = dest_y;
+    int i;
+
+    if (scale == 1)
+    {
+      for (x = 0; x < width; x++)
+        *dest_y++ = tables->y[row[x]];
+      continue;
+    }
+
+    for (x = 0; x < width; x++, dest_y += scale)
+      memset(dest_y, tables->y[row[x]], scale);
+
+    for (i = 1; i < scale; i++, dest_y += out_width)
+      memcpy(dest_y, first, out_width);
+  }
+
+  // chroma is averaged over each 2x2 block of the output, edges are clamped
+  for (y = 0; y < ch; y++)
+  {
+    int y1 = 2 * y;
+    int y2 = (y1 + 1 < out_height) ? y1 + 1 : y1;
+    const byte *row1 = src + (y1 / scale) * pitch;
+    const byte *row2 = src + (y2 / scale) * pitch;
+    int sx = 0, sub = 0; // output column sx * scale + sub
+
+    for (x = 0; x < cw; x++)
+    {
+      int x1, x2;
+      byte p1, p2, p3, p4;
+
+      x1 = sx;
+      if (++sub == scale)
+        sub = 0, sx++;
+
+      x2 = (2 * x + 1 < out_width) ? sx : x1;
+      if (++sub == scale)
+        sub = 0, sx++;
+
+      p1 = row1[x1], p2 = row1[x2], p3 = row2[x1], p4 = row2[x2];
+
+      *dest_u++ = (tables->u[p1] + tables->u[p2] + tables->u[p3] + tables->u[p4] + 2) >> 2;
+      *dest_v++ = (tables->v[p1] + tables->v[p2] + tables->v[p3] + tables->v[p4] + 2) >> 2;
+    }
+  }
+}
+
+// Converts an 8-bit frame, safe to call from any thread
+void I_ConvertScreenIndexed(byte *dest, const byte *src, int pitch, int width, int height,
+                            int scale, const SDL_Color *colors, grab_format_t format)
+{
+  grab_tables_t tables;
+
+  I_UpdateGrabTables(&tables, colors, format);
+
+  if (format == grab_format_rgb24)
+  {
+    int y, i;
+    int row_size = width * scale * 3;
+
+    for (y = 0; y < height; y++)
+    {
+      byte *row = dest + y * scale * row_size;
+
+      if (scale == 1)
+      {
+        I_GrabRowRGB24(&tables, row, src + y * pitch, width);
+        continue;
+      }
+
+      I_GrabRowRGB24Scaled(&tables, row, src + y * pitch, width, scale);
+
+      for (i = 1; i < scale; i++)
+        memcpy(row + i * row_size, row, row_size);
+    }
+  }
+  else
+  {
+    I_GrabFrameYUV420(&tables, dest, src, pitch, width, height, scale);
+  }
+}
+
+int I_GrabScreenIndexedSize(grab_format_t format, int scale)
+{
+  int width = SCREENWIDTH * scale;
+  int height = SCREENHEIGHT * scale;
+
+  if (format == grab_format_rgb24)
+    return width * height * 3;
+
+  return width * height + 2 * ((width + 1) >> 1) * ((height + 1) >> 1);
+}
+
+unsigned char *I_GrabScreenIndexed(grab_format_t format, int scale)
+{
+  static unsigned char *pixels = NULL;
+  static int pixels_size = 0;
+  int size;
+
+  if (!V_IsSoftwareMode() || !screens[0].data)
+    return NULL;
+
+  size = I_GrabScreenIndexedSize(format, scale);
+  if (!pixels || size > pixels_size)
+  {
+    pixels_size = size;
+    pixels = (unsigned char*)Z_Realloc(pixels, size);
+  }
+
+  I_ConvertScreenIndexed(pixels, screens[0].data, screens[0].pitch,
+                         SCREENWIDTH, SCREENHEIGHT, scale, I_GetScreenPalette(), format);
+
+  return pixels;
+}
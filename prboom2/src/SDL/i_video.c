@@ -531,6 +531,9 @@ static void I_UploadNewPalette(int pal, int force)
 
 void I_ShutdownGraphics(void)
 {
+  if (I_Headless())
+    return;
+
   SDL_FreeCursor(cursors[1]);
   DeactivateMouse();
 }
@@ -616,6 +619,12 @@ void I_FinishUpdate (void)
     newpal = NO_PALETTE_CHANGE;
   }
 
+  // No window to present to, the frame only goes to the capture sink
+  if (I_Headless()) {
+    I_HandleCapture();
+    return;
+  }
+
   // Blit from the paletted 8-bit screen buffer to the intermediate
   // 32-bit RGBA buffer that we can load into the texture.
   SDL_LowerBlit(screen, &src_rect, buffer, &src_rect);
@@ -646,6 +655,16 @@ void I_SetPalette (int pal)
   newpal = pal;
 }
 
+const SDL_Color *I_GetScreenPalette (void)
+{
+  if (newpal != NO_PALETTE_CHANGE) {
+    I_UploadNewPalette(newpal, false);
+    newpal = NO_PALETTE_CHANGE;
+  }
+
+  return screen->format->palette->colors;
+}
+
 // I_PreInitGraphics
 
 static void I_ShutdownSDL(void)
@@ -661,14 +680,24 @@ static void I_ShutdownSDL(void)
   return;
 }
 
+dboolean I_Headless(void)
+{
+  return dsda_Flag(dsda_arg_headless);
+}
+
 void I_PreInitGraphics(void)
 {
   int p;
 
   // Initialize SDL
   unsigned int flags = 0;
-  if (!(dsda_Flag(dsda_arg_nodraw) && dsda_Flag(dsda_arg_nosound)))
+  if (!(dsda_Flag(dsda_arg_nodraw) && dsda_Flag(dsda_arg_nosound)) && !I_Headless())
     flags = SDL_INIT_VIDEO;
+
+  // headless machines usually have no sound device either,
+  // captured sound doesn't need one
+  if (I_Headless())
+    SDL_setenv("SDL_AUDIODRIVER", "dummy", 0);
 #ifdef PRBOOM_DEBUG
   flags |= SDL_INIT_NOPARACHUTE;
 #endif
@@ -1056,7 +1085,7 @@ void I_InitScreenResolution(void)
   char c, x;
   dsda_arg_t *arg;
   video_mode_t mode;
-  int init = (sdl_window == NULL);
+  int init = (sdl_window == NULL && screen == NULL);
 
   I_GetScreenResolution();
 
@@ -1119,7 +1148,8 @@ void I_InitScreenResolution(void)
     h = desired_screenheight;
   }
 
-  mode = I_DesiredVideoMode();
+  // headless drawing is only supported by the software renderer
+  mode = I_Headless() ? VID_MODESW : I_DesiredVideoMode();
 
   V_InitMode(mode);
 
@@ -1190,6 +1220,9 @@ void I_InitGraphics(void)
     /* Set the video mode */
     I_UpdateVideoMode();
 
+    if (I_Headless())
+      return;
+
     //e6y: setup the window title
     I_SetWindowCaption();
 
@@ -1223,7 +1256,7 @@ void I_UpdateVideoMode(void)
   screen_multiply = dsda_IntConfig(dsda_config_render_screen_multiply);
   integer_scaling = dsda_IntConfig(dsda_config_integer_scaling);
 
-  if(sdl_window)
+  if(sdl_window || screen)
   {
     // video capturing cannot be continued with new screen settings
     I_CaptureFinish();
@@ -1241,7 +1274,7 @@ void I_UpdateVideoMode(void)
     if (buffer) SDL_FreeSurface(buffer);
     if (sdl_texture) SDL_DestroyTexture(sdl_texture);
     if (sdl_renderer) SDL_DestroyRenderer(sdl_renderer);
-    SDL_DestroyWindow(sdl_window);
+    if (sdl_window) SDL_DestroyWindow(sdl_window);
 
     sdl_renderer = NULL;
     sdl_window = NULL;
@@ -1272,7 +1305,16 @@ void I_UpdateVideoMode(void)
     init_flags |= SDL_WINDOW_RESIZABLE;
 #endif
 
-  if (V_IsOpenGLMode())
+  if (I_Headless())
+  {
+    // offscreen software buffer only: no window, renderer or texture
+    screen = SDL_CreateRGBSurface(0, SCREENWIDTH, SCREENHEIGHT, 8, 0, 0, 0, 0);
+
+    if(screen == NULL) {
+      I_Error("Couldn't set %dx%d headless mode [%s]", SCREENWIDTH, SCREENHEIGHT, SDL_GetError());
+    }
+  }
+  else if (V_IsOpenGLMode())
   {
     SDL_GL_SetAttribute( SDL_GL_RED_SIZE, 0 );
     SDL_GL_SetAttribute( SDL_GL_GREEN_SIZE, 0 );
@@ -1352,7 +1394,7 @@ void I_UpdateVideoMode(void)
     }
   }
 
-  if (sdl_video_window_pos)
+  if (sdl_video_window_pos && sdl_window)
   {
     int x, y;
     if (sscanf(sdl_video_window_pos, "%d,%d", &x, &y) == 2)
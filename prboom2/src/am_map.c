@@ -62,6 +62,9 @@
 #include "dsda/messenger.h"
 #include "dsda/settings.h"
 #include "dsda/stretch.h"
+#include "dsda/utility.h"
+
+#include "cman.h"
 
 //jff 1/7/98 default automap colors added
 int mapcolor_back;    // map background
@@ -1760,6 +1763,52 @@ static void AM_drawWalls(void)
   }
 }
 
+//
+// AM_drawCameramanPath()
+//
+// Previews the loaded Cameraman path, using the precomputed path table.
+// Long paths are decimated to keep the line count bounded.
+//
+#define AM_CMAN_PATH_LINES 4096
+
+static void AM_mapCameramanPoint(const cman_sample_t *sample, mpoint_t *p)
+{
+  p->x = dsda_FloatToFixed(sample->x) >> FRACTOMAPBITS;
+  p->y = dsda_FloatToFixed(sample->y) >> FRACTOMAPBITS;
+
+  if (automap_rotate)
+    AM_rotatePoint(p);
+  else
+    AM_SetMPointFloatValue(p);
+}
+
+static void AM_drawCameramanPath(int color)
+{
+  const cman_sample_t *samples;
+  int count, step, i;
+  mline_t l;
+
+  count = CMAN_PathSamples(&samples);
+  if (count < 2)
+    return;
+
+  step = (count + AM_CMAN_PATH_LINES - 1) / AM_CMAN_PATH_LINES;
+
+  AM_mapCameramanPoint(&samples[0], &l.a);
+  for (i = step; ; i += step)
+  {
+    if (i >= count)
+      i = count - 1;
+
+    AM_mapCameramanPoint(&samples[i], &l.b);
+    AM_drawMline(&l, color);
+    l.a = l.b;
+
+    if (i == count - 1)
+      break;
+  }
+}
+
 //
 // AM_drawLineCharacter()
 //
@@ -2578,6 +2627,7 @@ void AM_Drawer (dboolean minimap)
   if (automap_grid)
     AM_drawGrid((*mapcolor_grid_p));      //jff 1/7/98 grid default color
   AM_drawWalls();
+  AM_drawCameramanPath((*mapcolor_sngl_p));
   AM_drawPlayers();
   AM_drawThings(); //jff 1/5/98 default double IDDT sprite
   AM_drawCrosshair((*mapcolor_hair_p));   //jff 1/7/98 default crosshair color
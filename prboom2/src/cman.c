@@ -38,9 +38,12 @@
 #define CMAN_ANGLE_MODE_ABSOLUTE    1
 
 #define CMAN_CONFIG_BUFFER_SIZE     1024
+#define CMAN_ARC_SAMPLES            1024
+#define CMAN_PATH_PRECOMPUTE_TICS   (35 * 60 * 10)
+#define CMAN_RAW_RING_SIZE          2048
 
 // Input cameraman parameters.
-struct
+typedef struct
 {
   int delay;
   int path_mode;
@@ -49,6 +52,7 @@ struct
   int overshoot;
   int warp_player;
   int hide_player;
+  int arc_length;
   int ga_buffer_len;
   float speed;
   float x0;
@@ -72,7 +76,15 @@ struct
   float cx1;
   float cy0;
   float cy1;
-} cman;
+} cman_params_t;
+
+// Parameters of the segment being evaluated.
+cman_params_t cman;
+
+// Profile segments, played one after another.
+// Segment parameters are copied into 'cman' for evaluation.
+cman_params_t* cman_segments;
+int cman_segment_count;
 
 // Output values for camera position.
 struct
@@ -91,16 +103,55 @@ dboolean cman_auto_exit = false;
 // Track active state to detect changes
 dboolean cman_was_active = false;
 
-// Angle buffer
-struct
+// Cumulative Bezier arc length, sampled evenly along the curve parameter
+typedef struct
 {
-  float values[1024];
-  int index;
-  float sum;
-} cman_angle_buffer;
+  float length[CMAN_ARC_SAMPLES + 1];
+  dboolean enabled;
+} cman_arc_t;
 
-// Previous tangent angle (relevant to Bezier)
-float prev_tangent_angle;
+// Arc length of every segment, and the one of the segment being evaluated
+cman_arc_t* cman_arcs;
+cman_arc_t* cman_arc;
+
+// First tic of every segment, filled in as the path is generated
+int* cman_segment_starts;
+
+// Tic the camera was last placed at by the ticker, -1 if it wasn't
+int cman_view_tic = -1;
+
+// Precomputed camera path, one sample per tic of Cameraman time.
+// The sample at 'length' is the completed position, kept for interpolation.
+struct
+{
+  cman_sample_t* samples;
+  int* segments;
+  int count;
+  int size;
+  int length; // -1 while the path end is not reached yet
+} cman_path = { NULL, NULL, 0, 0, -1 };
+
+// Unfiltered camera state at one tic, before angle smoothing.
+typedef struct
+{
+  cman_sample_t value;
+  int segment;
+  dboolean completed;
+} cman_raw_t;
+
+// Path generator state.
+// Raw values run ahead of the path table by half the angle buffer,
+// and wrap around a ring big enough for the whole buffer.
+struct
+{
+  cman_raw_t raw[CMAN_RAW_RING_SIZE];
+  int raw_first;
+  int raw_next;
+  int segment;
+  int segment_start;
+  dboolean completed;
+  float angle_sum;
+} cman_gen;
 
 // Converts ZDoom-style angle (between 0.0 and 1.0) to BAM.
 angle_t CMAN_FromZDoomAngle(float a)
@@ -128,24 +179,14 @@ float CMAN_VectorAngle(float x, float y)
 }
 
 // Corrects an angle, that crosses zero threshold (represents EAST) in relation to some previous angle value.
-// The result should move two angles closer together.
+// The result should move two angles closer together, by as many full turns as needed.
 // Examples:
 //   given prev_angle=0.99, angle=0.01 is corrected to 1.01.
 //   given prev_angle=0.01, angle=0.99 is corrected -0.01.
+//   given prev_angle=2.25, angle=0.5 is corrected to 2.5.
 float CMAN_FixAngleCrossingEast(float angle, float prev_angle)
 {
-  if (angle - prev_angle < -0.5f)
-  {
-    // Crossed 1.0 moving counter-clockwise
-    return angle + 1.f;
-  }
-  else if (angle - prev_angle > 0.5f)
-  {
-    // Crossed 0.0 moving clockwise
-    return angle - 1.f;
-  }
-
-  return angle;
+  return angle + floorf(prev_angle - angle + 0.5f);
 }
 
 // Outputs next values for Linear path mode.
@@ -221,21 +262,100 @@ float CMAN_NextRadialValues(float t, dboolean overshoot)
   return progress;
 }
 
+// Point on the Bezier curve at parameter u.
+void CMAN_BezierPoint(float u, float* x, float* y, float* z)
+{
+  float u2 = u * u;
+  float omu = 1.f - u;
+  float omu2 = omu * omu;
+
+  *x = cman.x1 + omu2 * (cman.x0 - cman.x1) + u2 * (cman.x2 - cman.x1);
+  *y = cman.y1 + omu2 * (cman.y0 - cman.y1) + u2 * (cman.y2 - cman.y1);
+  *z = cman.z1 + omu2 * (cman.z0 - cman.z1) + u2 * (cman.z2 - cman.z1);
+}
+
+// Samples the Bezier arc length, so that the curve can be walked at constant speed.
+void CMAN_InitArcLength()
+{
+  float prevx, prevy, prevz;
+  float x, y, z;
+
+  cman_arc->enabled = false;
+  if (!cman.arc_length || cman.path_mode != CMAN_PATH_MODE_BEZIER)
+    return;
+
+  CMAN_BezierPoint(0, &prevx, &prevy, &prevz);
+  cman_arc->length[0] = 0;
+
+  for (int i = 1; i <= CMAN_ARC_SAMPLES; i++)
+  {
+    CMAN_BezierPoint((float)i / CMAN_ARC_SAMPLES, &x, &y, &z);
+    cman_arc->length[i] = cman_arc->length[i - 1] + CMAN_VectorLength(x - prevx, y - prevy);
+    prevx = x;
+    prevy = y;
+  }
+
+  // A degenerate curve has no length to walk, fall back to time
+  cman_arc->enabled = cman_arc->length[CMAN_ARC_SAMPLES] > 0;
+}
+
+// Converts distance along the Bezier curve into the curve parameter.
+// Distances outside the curve are extrapolated from the end segments.
+float CMAN_ArcLengthToParam(float s)
+{
+  int lo = 0;
+  int hi = CMAN_ARC_SAMPLES;
+
+  if (s >= cman_arc->length[CMAN_ARC_SAMPLES])
+  {
+    lo = CMAN_ARC_SAMPLES - 1;
+  }
+  else if (s > 0)
+  {
+    while (hi - lo > 1)
+    {
+      int mid = (lo + hi) / 2;
+
+      if (cman_arc->length[mid] <= s)
+        lo = mid;
+      else
+        hi = mid;
+    }
+  }
+
+  float segment = cman_arc->length[lo + 1] - cman_arc->length[lo];
+  float fraction = segment > 0 ? (s - cman_arc->length[lo]) / segment : 0;
+
+  return (lo + fraction) / CMAN_ARC_SAMPLES;
+}
+
+// Bezier progress after t tics.
+// Time mode completes the curve in 'speed' tics, arc length mode moves 'speed' units per tic.
+float CMAN_BezierProgress(float t)
+{
+  if (cman_arc->enabled)
+    return cman.speed * t / cman_arc->length[CMAN_ARC_SAMPLES];
+
+  return cman.speed ? t / cman.speed : 0;
+}
+
+// Bezier curve parameter after t tics.
+float CMAN_BezierParam(float t)
+{
+  if (cman_arc->enabled)
+    return CMAN_ArcLengthToParam(cman.speed * t);
+
+  return CMAN_BezierProgress(t);
+}
+
 // Outputs next values for Bezier path mode.
 float CMAN_NextBezierValues(float t, dboolean overshoot)
 {
-  float progress = cman.speed ? t / cman.speed : 0;
+  float progress = CMAN_BezierProgress(t);
 
   if (overshoot || progress < 1.f)
   {
-    float p = progress;
-    float p2 = p * p;
-    float omp = 1.f - p;
-    float omp2 = omp * omp;
-
-    cman_out.x = cman.x1 + omp2 * (cman.x0 - cman.x1) + p2 * (cman.x2 - cman.x1);
-    cman_out.y = cman.y1 + omp2 * (cman.y0 - cman.y1) + p2 * (cman.y2 - cman.y1);
-    cman_out.z = cman.z1 + omp2 * (cman.z0 - cman.z1) + p2 * (cman.z2 - cman.z1);
+    CMAN_BezierPoint(CMAN_BezierParam(t), &cman_out.x, &cman_out.y, &cman_out.z);
     cman_out.a = cman.a0 + (cman.a1 - cman.a0) * progress;
     cman_out.p = cman.p0 + (cman.p1 - cman.p0) * progress;
   }
@@ -250,20 +370,11 @@ float CMAN_NextBezierValues(float t, dboolean overshoot)
 
   if (cman.angle_mode == CMAN_ANGLE_MODE_RELATIVE)
   {
-    float p = (t - 1.f) / cman.speed;
-    float p2 = p * p;
-    float omp = 1.f - p;
-    float omp2 = omp * omp;
-
-    float prevx = cman.x1 + omp2 * (cman.x0 - cman.x1) + p2 * (cman.x2 - cman.x1);
-    float prevy = cman.y1 + omp2 * (cman.y0 - cman.y1) + p2 * (cman.y2 - cman.y1);
+    float prevx, prevy, prevz;
 
-    float tangent_angle = CMAN_VectorAngle(cman_out.x - prevx, cman_out.y - prevy);
-    if (cman_was_active)
-      tangent_angle = CMAN_FixAngleCrossingEast(tangent_angle, prev_tangent_angle);
+    CMAN_BezierPoint(CMAN_BezierParam(t - 1.f), &prevx, &prevy, &prevz);
 
-    prev_tangent_angle = tangent_angle;
-    cman_out.a += tangent_angle;
+    cman_out.a += CMAN_VectorAngle(cman_out.x - prevx, cman_out.y - prevy);
   }
 
   return progress;
@@ -283,60 +394,204 @@ float CMAN_NextValuesUnbuffered(float t, dboolean overshoot)
   return 1.f;
 }
 
-// Calculate next values for cman_angle_buffer.
-void CMAN_NextBufferValues(float t)
+// Makes segment i the one evaluated by the path functions.
+void CMAN_LoadSegment(int i)
+{
+  cman = cman_segments[i];
+  cman_arc = &cman_arcs[i];
+}
+
+// Whether relative Bezier angles of the segment are averaged over the angle buffer.
+dboolean CMAN_SmoothAngles(const cman_params_t* params)
+{
+  return
+    params->ga_buffer_len > 1 &&
+    params->path_mode == CMAN_PATH_MODE_BEZIER &&
+    params->angle_mode == CMAN_ANGLE_MODE_RELATIVE;
+}
+
+// Index of tic t in the raw value ring.
+int CMAN_RawIndex(int t)
+{
+  return ((t % CMAN_RAW_RING_SIZE) + CMAN_RAW_RING_SIZE) % CMAN_RAW_RING_SIZE;
+}
+
+// Generates the next raw value of the whole timeline.
+// Tics before the start and after the end extrapolate the first and last segments,
+// so the angle buffer has something to average over at both ends.
+void CMAN_NextRawValue()
 {
-  float next_buffer_t = t + 1.f * (cman.ga_buffer_len / 2);
+  int t = cman_gen.raw_next++;
+  cman_raw_t* raw = &cman_gen.raw[CMAN_RawIndex(t)];
+  float progress = CMAN_NextValuesUnbuffered((float)(t - cman_gen.segment_start), true);
 
-  if (!cman_was_active)
+  raw->completed = false;
+
+  if (t >= 0 && !cman_gen.completed)
   {
-    // Fill the whole buffer first time around
-    cman_angle_buffer.sum = 0;
-    float buffer_t = next_buffer_t;
-    for (int i = cman.ga_buffer_len - 1; i >= 0; i--)
+    // Written this way so that a NaN progress also completes the segment
+    while (!(progress < 1.f) && cman_gen.segment < cman_segment_count - 1)
+    {
+      CMAN_LoadSegment(++cman_gen.segment);
+      cman_gen.segment_start = t;
+      cman_segment_starts[cman_gen.segment] = t;
+      progress = CMAN_NextValuesUnbuffered(0, true);
+    }
+
+    if (!(progress < 1.f))
     {
-      CMAN_NextValuesUnbuffered(buffer_t, true);
-      cman_angle_buffer.values[i] = cman_out.a;
-      cman_angle_buffer.sum += cman_out.a;
-      buffer_t -= 1.f;
+      // Completed position of the last segment, honoring its overshoot setting
+      CMAN_NextValuesUnbuffered((float)(t - cman_gen.segment_start), cman.overshoot);
+      cman_gen.completed = true;
+      raw->completed = true;
     }
   }
-  else
+
+  raw->value.x = cman_out.x;
+  raw->value.y = cman_out.y;
+  raw->value.z = cman_out.z;
+  raw->value.p = cman_out.p;
+  raw->value.a = cman_out.a;
+  raw->segment = cman_gen.segment;
+
+  // Keep angles continuous, so that averaging across a turn or a segment boundary works
+  if (t != cman_gen.raw_first)
+    raw->value.a = CMAN_FixAngleCrossingEast(raw->value.a, cman_gen.raw[CMAN_RawIndex(t - 1)].value.a);
+}
+
+// Generates path samples in order up to tic t, or until the path is completed.
+// Relative Bezier angles are averaged over 'ga_buffer_len' tics centered on each sample,
+// and the average runs across segment boundaries to smooth the transition.
+void CMAN_ExtendPath(int t)
+{
+  int half = cman.ga_buffer_len / 2;
+
+  if (!cman_path.count)
   {
-    // Update only the buffer's difference
-    CMAN_NextValuesUnbuffered(next_buffer_t, true);
-    cman_angle_buffer.sum -= cman_angle_buffer.values[cman_angle_buffer.index];
-    cman_angle_buffer.sum += cman_out.a;
-    cman_angle_buffer.values[cman_angle_buffer.index] = cman_out.a;
+    // Prime the angle buffer with the tics leading up to the first sample
+    CMAN_LoadSegment(0);
+    cman_gen.segment = 0;
+    cman_gen.segment_start = 0;
+    cman_gen.completed = false;
+    cman_gen.raw_first = half - cman.ga_buffer_len + 1;
+    cman_gen.raw_next = cman_gen.raw_first;
+    cman_gen.angle_sum = 0;
+
+    while (cman_gen.raw_next < half)
+    {
+      CMAN_NextRawValue();
+      cman_gen.angle_sum += cman_gen.raw[CMAN_RawIndex(cman_gen.raw_next - 1)].value.a;
+    }
   }
 
-  // Advance the cyclic buffer index
-  cman_angle_buffer.index++;
-  if (cman_angle_buffer.index == cman.ga_buffer_len)
-    cman_angle_buffer.index = 0;
+  while (cman_path.count <= t && cman_path.length < 0)
+  {
+    int i = cman_path.count;
+
+    if (cman_path.count == cman_path.size)
+    {
+      cman_path.size = cman_path.size ? cman_path.size * 2 : 1024;
+      cman_path.samples = Z_Realloc(cman_path.samples, cman_path.size * sizeof(*cman_path.samples));
+      cman_path.segments = Z_Realloc(cman_path.segments, cman_path.size * sizeof(*cman_path.segments));
+    }
+
+    // Slide the angle buffer window to [i + half - len + 1, i + half]
+    CMAN_NextRawValue();
+    cman_gen.angle_sum += cman_gen.raw[CMAN_RawIndex(i + half)].value.a;
+    if (i > 0)
+      cman_gen.angle_sum -= cman_gen.raw[CMAN_RawIndex(i + half - cman.ga_buffer_len)].value.a;
+
+    cman_raw_t* raw = &cman_gen.raw[CMAN_RawIndex(i)];
+    cman_sample_t* sample = &cman_path.samples[i];
+
+    *sample = raw->value;
+    cman_path.segments[i] = raw->segment;
+    if (CMAN_SmoothAngles(&cman_segments[raw->segment]))
+      sample->a = cman_gen.angle_sum / cman.ga_buffer_len;
+
+    if (raw->completed)
+      cman_path.length = i;
+
+    cman_path.count++;
+  }
 }
 
-// Outputs next values, depending on the path mode.
-// Applies angle filtering if needed.
-float CMAN_NextValues(float t)
+// Returns the camera state at tic t, or NULL once the path is completed.
+const cman_sample_t* CMAN_PathSample(int t)
 {
-  dboolean angle_buffering_needed =
-    cman.ga_buffer_len > 1 &&
-    cman.path_mode == CMAN_PATH_MODE_BEZIER &&
-    cman.angle_mode == CMAN_ANGLE_MODE_RELATIVE;
+  CMAN_ExtendPath(t);
 
-  // Calculate angle buffer data first to not mess with the output below
-  if (angle_buffering_needed)
-    CMAN_NextBufferValues(t);
+  if (cman_path.length >= 0 && t >= cman_path.length)
+    return NULL;
 
-  // Calculate next positional and angle values, this should output to cman_out
-  float progress = CMAN_NextValuesUnbuffered(t, cman.overshoot);
+  return &cman_path.samples[t];
+}
 
-  // Adjust the angle using the buffer if needed
-  if (angle_buffering_needed)
-    cman_out.a = cman_angle_buffer.sum / cman.ga_buffer_len;
+// Exposes the generated path, e.g. to preview it on the automap.
+// Returns the number of samples, including the completed position.
+int CMAN_PathSamples(const cman_sample_t** samples)
+{
+  *samples = cman_path.samples;
 
-  return progress;
+  if (cman.delay < 0)
+    return 0;
+
+  return cman_path.length >= 0 ? cman_path.length + 1 : cman_path.count;
+}
+
+// Evaluates the camera path at fraction f of the way from the previous tic to 'tic'.
+// Positions and pitch are exact, so curves stay curved between tics.
+// Averaged angles change slowly and are interpolated between the tic samples instead.
+void CMAN_PathValues(int tic, float f, cman_sample_t* out)
+{
+  float t = tic - 1 + f;
+  int segment = cman_path.segments[tic];
+  const cman_sample_t* prev = &cman_path.samples[tic - 1];
+  const cman_sample_t* next = &cman_path.samples[tic];
+
+  // Time between the segments belongs to the end of the previous one
+  if (t < cman_segment_starts[segment])
+    segment = cman_path.segments[tic - 1];
+
+  cman_params_t gen_params = cman;
+  cman_arc_t* gen_arc = cman_arc;
+
+  CMAN_LoadSegment(segment);
+  CMAN_NextValuesUnbuffered(t - cman_segment_starts[segment], false);
+
+  out->x = cman_out.x;
+  out->y = cman_out.y;
+  out->z = cman_out.z;
+  out->p = cman_out.p;
+
+  if (CMAN_SmoothAngles(&cman))
+    out->a = prev->a + (next->a - prev->a) * f;
+  else
+    out->a = CMAN_FixAngleCrossingEast(cman_out.a, prev->a);
+
+  // Leave the generator where it was
+  cman = gen_params;
+  cman_arc = gen_arc;
+}
+
+// Meant to be called from R_InterpolateView while the camera view is interpolated.
+// Replaces the view interpolated between two tics with the camera path at the exact frame time,
+// e.g. at each video capture frame.
+void CMAN_InterpolateView(fixed_t frac)
+{
+  cman_sample_t sample;
+
+  // Nothing to interpolate from at the first tic
+  if (cman_view_tic < 1 || walkcamera.type != 2 || frac < 0 || frac >= FRACUNIT)
+    return;
+
+  CMAN_PathValues(cman_view_tic, (float)frac / FRACUNIT, &sample);
+
+  viewx = dsda_FloatToFixed(sample.x);
+  viewy = dsda_FloatToFixed(sample.y);
+  viewz = dsda_FloatToFixed(sample.z);
+  viewangle = CMAN_FromZDoomAngle(sample.a);
+  viewpitch = CMAN_FromZDoomAngle(sample.p);
 }
 
 // Meant to be called every gametic from P_WalkTicker.
@@ -352,6 +607,7 @@ int CMAN_Ticker()
   {
     walkcamera.type = 0;
     cman_was_active = false;
+    cman_view_tic = -1;
   }
 
   // Cameraman time must be exactly 0 after the current level has started and 'delay' tics have passed
@@ -360,12 +616,12 @@ int CMAN_Ticker()
   if (cman_time < 0)
     return false;
 
-  // Calculate next camera values
-  float t = (float)cman_time;
-  float progress = CMAN_NextValues(t);
+  // Look up the precomputed camera values
+  const cman_sample_t* sample = CMAN_PathSample(cman_time);
+  cman_view_tic = sample ? cman_time : -1;
 
   // Update the camera values as long as the camera path is not completed
-  if (progress < 1.f)
+  if (sample)
   {
     // Disable interpolation for one frame and abruptly jump to the camera starting position
     if (!cman_was_active)
@@ -373,11 +629,11 @@ int CMAN_Ticker()
 
     // type=2 means 'freecam' mode (the kind controlled separately from the player model during demo playback)
     walkcamera.type = 2;
-    walkcamera.x = dsda_FloatToFixed(cman_out.x);
-    walkcamera.y = dsda_FloatToFixed(cman_out.y);
-    walkcamera.z = dsda_FloatToFixed(cman_out.z);
-    walkcamera.angle = CMAN_FromZDoomAngle(cman_out.a);
-    walkcamera.pitch = CMAN_FromZDoomAngle(cman_out.p);
+    walkcamera.x = dsda_FloatToFixed(sample->x);
+    walkcamera.y = dsda_FloatToFixed(sample->y);
+    walkcamera.z = dsda_FloatToFixed(sample->z);
+    walkcamera.angle = CMAN_FromZDoomAngle(sample->a);
+    walkcamera.pitch = CMAN_FromZDoomAngle(sample->p);
 
     // Player mobj to manipulate if needed
     mobj_t* player = players[displayplayer].mo;
@@ -426,6 +682,7 @@ void CMAN_InitDefaults()
   cman.overshoot = false;
   cman.warp_player = false;
   cman.hide_player = false;
+  cman.arc_length = false;
   cman.ga_buffer_len = 128;
   cman.speed = 1.f;
 }
@@ -461,6 +718,27 @@ float CMAN_FloatInRange(float value, float min, float max)
     return value;
 }
 
+// Finishes the segment being parsed.
+// The next segment starts as a copy of it, so only the changed params need to be listed.
+void CMAN_PushSegment()
+{
+  cman_segments = Z_Realloc(cman_segments, (cman_segment_count + 1) * sizeof(*cman_segments));
+  cman_segments[cman_segment_count++] = cman;
+}
+
+// Params that apply to the whole profile take their last parsed values in every segment.
+void CMAN_ApplyGlobalParams()
+{
+  for (int i = 0; i < cman_segment_count; i++)
+  {
+    cman_segments[i].delay = cman.delay;
+    cman_segments[i].overshoot = cman.overshoot;
+    cman_segments[i].warp_player = cman.warp_player;
+    cman_segments[i].hide_player = cman.hide_player;
+    cman_segments[i].ga_buffer_len = cman.ga_buffer_len;
+  }
+}
+
 // Meant to be called only once during the game startup.
 void CMAN_Init()
 {
@@ -503,6 +781,7 @@ void CMAN_Init()
 
   // Parse .cman file line-by-line
   // Each line is expected to be '<param> = <value>'
+  // A 'segment = <any>' line ends the current segment and starts the next one
   // Unrecognized lines and param names are ignored
   FILE* f = M_OpenFile(cman_file, "r");
   Z_Free(cman_file);
@@ -521,7 +800,9 @@ void CMAN_Init()
 
       lprintf(LO_DEBUG, " Cameraman param: %s = %f\n", param_name, param_value);
 
-      if (!strcmp(param_name, "path_mode"))
+      if (!strcmp(param_name, "segment"))
+        CMAN_PushSegment();
+      else if (!strcmp(param_name, "path_mode"))
         cman.path_mode = CMAN_EnumInRange((int)param_value, CMAN_PATH_MODE_LINEAR, CMAN_PATH_MODE_BEZIER);
       else if (!strcmp(param_name, "speed_mode"))
         cman.speed_mode = CMAN_EnumInRange((int)param_value, CMAN_SPEED_MODE_DISTANCE, CMAN_SPEED_MODE_TIME);
@@ -535,6 +816,8 @@ void CMAN_Init()
         cman.warp_player = (int)param_value;
       else if (!strcmp(param_name, "hide_player"))
         cman.hide_player = (int)param_value;
+      else if (!strcmp(param_name, "arc_length"))
+        cman.arc_length = (int)param_value;
       else if (!strcmp(param_name, "ga_buffer_len"))
         cman.ga_buffer_len = CMAN_IntInRange((int)param_value, 1, 1024);
       else if (!strcmp(param_name, "speed"))
@@ -587,6 +870,27 @@ void CMAN_Init()
   }
 
   Z_Free(line);
+
+  CMAN_PushSegment();
+  CMAN_ApplyGlobalParams();
+
+  if (cman_segment_count > 1)
+    lprintf(LO_INFO, "Cameraman segments: %d\n", cman_segment_count);
+
+  cman_arcs = Z_Calloc(cman_segment_count, sizeof(*cman_arcs));
+  cman_segment_starts = Z_Calloc(cman_segment_count, sizeof(*cman_segment_starts));
+
+  for (int i = 0; i < cman_segment_count; i++)
+  {
+    CMAN_LoadSegment(i);
+    CMAN_InitArcLength();
+  }
+
+  // Compile the path up front, longer paths are extended while playing
+  CMAN_ExtendPath(CMAN_PATH_PRECOMPUTE_TICS - 1);
+
+  if (cman_path.length >= 0)
+    lprintf(LO_INFO, "Cameraman path: %d tics\n", cman_path.length);
 }
 
 // Meant to be called when setting up skiptics. Returns amount of tics to skip or -1 if no skip is needed.
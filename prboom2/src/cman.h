@@ -17,8 +17,23 @@
 
 #ifndef __CMAN__
 #define __CMAN__
-#endif
+
+#include "m_fixed.h"
+
+// Camera state at one tic of the path.
+typedef struct
+{
+  float x;
+  float y;
+  float z;
+  float a;
+  float p;
+} cman_sample_t;
 
 int CMAN_Ticker();
+void CMAN_InterpolateView(fixed_t frac);
 void CMAN_Init();
 int CMAN_SkipTics();
+int CMAN_PathSamples(const cman_sample_t** samples);
+
+#endif
@@ -50,6 +50,7 @@
 #include "w_wad.h"
 #include "m_file.h"
 #include "m_misc.h"
+#include "md5.h"
 #include "v_video.h"
 #include "e6y.h"//e6y
 
@@ -1643,6 +1644,35 @@ void deh_applyCompatibility(void)
 
 static int processed_dehacked;
 
+// Checksum of every DEH file and lump processed so far, in order
+static struct MD5Context deh_md5;
+static dboolean deh_md5_started;
+
+static void UpdateDehChecksum(const void *data, int length)
+{
+  if (!deh_md5_started)
+  {
+    MD5Init(&deh_md5);
+    deh_md5_started = true;
+  }
+
+  MD5Update(&deh_md5, data, length);
+}
+
+void DehChecksum(unsigned char digest[16])
+{
+  struct MD5Context md5;
+
+  if (!deh_md5_started)
+  {
+    memset(digest, 0, 16);
+    return;
+  }
+
+  md5 = deh_md5;
+  MD5Final(digest, &md5);
+}
+
 void ProcessDehFile(const char *filename, const char *outfilename, int lumpnum)
 {
   DEHFILE infile, *filein = &infile;    // killough 10/98
@@ -1678,6 +1708,17 @@ void ProcessDehFile(const char *filename, const char *outfilename, int lumpnum)
     }
     infile.lump = NULL;
     file_or_lump = "file";
+
+    {
+      byte *buffer;
+      int length = M_ReadFile(filename, &buffer);
+
+      if (length >= 0)
+      {
+        UpdateDehChecksum(buffer, length);
+        Z_Free(buffer);
+      }
+    }
   }
   else  // DEH file comes from lump indicated by third argument
   {
@@ -1689,6 +1730,7 @@ void ProcessDehFile(const char *filename, const char *outfilename, int lumpnum)
       lprintf(LO_WARN, "skipping empty DEHACKED (%d) lump\n", lumpnum);
       return;
     }
+    UpdateDehChecksum(infile.lump, infile.size);
     filename = lumpinfo[lumpnum].wadfile->name;
     file_or_lump = "lump from";
   }
@@ -47,6 +47,9 @@
 void ProcessDehFile(const char *filename, const char *outfilename, int lumpnum);
 void PostProcessDeh(void);
 
+// MD5 of the DEH files and lumps processed so far, zero if none
+void DehChecksum(unsigned char digest[16]);
+
 //
 //      Ty 03/22/98 - note that we are keeping the english versions and
 //      comments in this file
@@ -86,6 +86,7 @@
 #include "dsda/args.h"
 #include "dsda/configuration.h"
 #include "dsda/demo.h"
+#include "dsda/demo_batch.h"
 #include "dsda/exdemo.h"
 #include "dsda/features.h"
 #include "dsda/global.h"
@@ -104,8 +105,10 @@
 #include "dsda/skill_info.h"
 #include "dsda/skip.h"
 #include "dsda/sndinfo.h"
+#include "dsda/sync_hash.h"
 #include "dsda/time.h"
 #include "dsda/utility.h"
+#include "dsda/viddump_segments.h"
 #include "dsda/wad_stats.h"
 #include "dsda/zipfile.h"
 #include "dsda/gl/render_scale.h"
@@ -1659,6 +1662,9 @@ static void D_DoomMainSetup(void)
     I_SafeExit(0);
   }
 
+  if (dsda_Flag(dsda_arg_synchash_compare))
+    dsda_CompareSyncHashes();
+
   // figgi 09/18/00-- added switch to force classic bsp nodes
   if (dsda_Flag(dsda_arg_forceoldbsp))
     forceOldBsp = true;
@@ -1985,7 +1991,10 @@ static void D_DoomMainSetup(void)
   arg = dsda_Arg(dsda_arg_viddump);
   if (arg->found)
   {
-    I_CapturePrep(arg->value.v_string);
+    if (dsda_Flag(dsda_arg_viddump_segments))
+      dsda_InitViddumpSegments(arg->value.v_string);
+    else
+      I_CapturePrep(arg->value.v_string);
   }
 
   //jff 9/3/98 use logical output routine
@@ -2002,6 +2011,10 @@ static void D_DoomMainSetup(void)
     dsda_InitDemoRecording();
   }
 
+  // Only returns in the processes that play the demos
+  if (dsda_Flag(dsda_arg_playdemo_batch))
+    dsda_RunDemoBatch();
+
   dsda_ExecutePlaybackOptions();
 
   if (!userdemo)
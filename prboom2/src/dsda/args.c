@@ -98,6 +98,26 @@ static arg_config_t arg_config[dsda_arg_count] = {
     "plays back the first file while writing to the second",
     arg_string_array, EXACT_ARRAY_LENGTH(2),
   },
+  [dsda_arg_playdemo_batch] = {
+    "-playdemo_batch", NULL, NULL,
+    "plays every demo in the given list file in parallel, writing results to a .jsonl report",
+    arg_string,
+  },
+  [dsda_arg_playdemo_batch_jobs] = {
+    "-playdemo_batch_jobs", NULL, NULL,
+    "sets how many demos -playdemo_batch plays at once (defaults to the cpu count)",
+    arg_int, 1, 256,
+  },
+  [dsda_arg_synchash] = {
+    "-synchash", NULL, NULL,
+    "writes hashes of the game state for every tic to the given file",
+    arg_string,
+  },
+  [dsda_arg_synchash_compare] = {
+    "-synchash_compare", NULL, NULL,
+    "compares two -synchash files and reports the first tic that differs",
+    arg_string_array, EXACT_ARRAY_LENGTH(2),
+  },
   [dsda_arg_from_key_frame] = {
     "-from_key_frame", NULL, NULL,
     "restores state and demo buffer from a key frame file",
@@ -398,6 +418,16 @@ static arg_config_t arg_config[dsda_arg_count] = {
     "dumps a video to the chosen file name",
     arg_string,
   },
+  [dsda_arg_viddump_segments] = {
+    "-viddump_segments", NULL, NULL,
+    "splits -viddump into the given number of segments rendered by parallel processes",
+    arg_int, 2, 64,
+  },
+  [dsda_arg_viddump_segment] = {
+    "-viddump_segment", NULL, NULL,
+    "renders one segment of a split viddump (index, end tic) - used internally",
+    arg_int_array, 0, INT_MAX, 2, 2,
+  },
   [dsda_arg_dehout] = {
     "-dehout", "-bexout", NULL,
     "sets dehacked log file",
@@ -478,6 +508,11 @@ static arg_config_t arg_config[dsda_arg_count] = {
     "turn off drawing",
     arg_null,
   },
+  [dsda_arg_headless] = {
+    "-headless", NULL, NULL,
+    "draws offscreen in software mode without a window (for video capture)",
+    arg_null,
+  },
   [dsda_arg_nodeh] = {
     "-nodeh", NULL, NULL,
     "skip dehacked lumps inside wads",
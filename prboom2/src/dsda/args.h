@@ -30,6 +30,10 @@ typedef enum {
   dsda_arg_fastdemo,
   dsda_arg_record,
   dsda_arg_recordfromto,
+  dsda_arg_playdemo_batch,
+  dsda_arg_playdemo_batch_jobs,
+  dsda_arg_synchash,
+  dsda_arg_synchash_compare,
   dsda_arg_from_key_frame,
   dsda_arg_warp,
   dsda_arg_skill,
@@ -90,6 +94,8 @@ typedef enum {
   dsda_arg_shotdir,
   dsda_arg_movie,
   dsda_arg_viddump,
+  dsda_arg_viddump_segments,
+  dsda_arg_viddump_segment,
   dsda_arg_dehout,
   dsda_arg_verbose,
   dsda_arg_quiet,
@@ -106,6 +112,7 @@ typedef enum {
   dsda_arg_nomusic,
   dsda_arg_nosfx,
   dsda_arg_nodraw,
+  dsda_arg_headless,
   dsda_arg_nodeh,
   dsda_arg_nomapinfo,
   dsda_arg_noautoload,
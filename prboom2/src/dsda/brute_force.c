@@ -16,19 +16,33 @@
 //
 
 #include <math.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#endif
 
 #include "d_player.h"
 #include "d_ticcmd.h"
 #include "doomstat.h"
+#include "g_game.h"
 #include "lprintf.h"
 #include "m_random.h"
 #include "r_state.h"
+#include "z_zone.h"
 
 #include "dsda/build.h"
+#include "dsda/configuration.h"
 #include "dsda/demo.h"
 #include "dsda/features.h"
 #include "dsda/key_frame.h"
+#include "dsda/key_frame_delta.h"
 #include "dsda/skip.h"
+#include "dsda/sync_hash.h"
 #include "dsda/time.h"
 #include "dsda/utility.h"
 
@@ -82,6 +96,35 @@ static dsda_key_frame_t nomo_key_frame;
 static bf_target_t bf_target;
 static ticcmd_t bf_result[MAX_BF_DEPTH];
 
+// World states already reached, keyed by hash and depth. A branch that
+// reaches a known state has the same subtree as the earlier branch, so
+// it can't succeed or improve the target and is skipped.
+#define BF_STATE_TABLE_MIN 4096
+#define BF_STATE_TABLE_MAX (1 << 22)
+
+static uint64_t* bf_state_table;
+static int bf_state_table_size;
+static int bf_state_count;
+static long long bf_subtree_volume[MAX_BF_DEPTH + 1];
+static long long bf_pruned;
+static long long bf_next_progress;
+static dboolean bf_exhausted;
+
+// Worker processes each test one contiguous slice of the sequences
+// and report back through a pipe, see dsda_RunBFWorkers
+typedef struct {
+  long long volume;
+  long long pruned;
+  dboolean success;
+  dboolean evaluated;
+  fixed_t best_value;
+  ticcmd_t result[MAX_BF_DEPTH];
+} bf_worker_result_t;
+
+static dboolean bf_worker;
+static int bf_worker_fd = -1;
+static long long bf_worker_start;
+
 const char* dsda_bf_attribute_names[dsda_bf_attribute_max] = {
   [dsda_bf_x] = "x",
   [dsda_bf_y] = "y",
@@ -182,10 +225,11 @@ static dboolean dsda_AdvanceBruteForceFrame(int frame) {
   return true;
 }
 
-static int dsda_AdvanceBruteForce(void) {
+// Moves to the next sequence that differs in this frame or an earlier one
+static int dsda_AdvanceBruteForce(int frame) {
   int i;
 
-  for (i = bf_depth - 1; i >= 0; --i)
+  for (i = frame; i >= 0; --i)
     if (dsda_AdvanceBruteForceFrame(i))
       break;
 
@@ -219,15 +263,114 @@ static void dsda_StoreBFKeyFrame(int frame) {
   dsda_StoreKeyFrame(&brute_force[frame].key_frame, true, false);
 }
 
+// Hashes what decides how the rest of the search plays out: the game
+// state packed as for -synchash, and the damage the target may read
+static uint64_t dsda_BFStateHash(int frame) {
+  extern int player_damage_last_tic;
+
+  const unsigned int* words;
+  uint64_t hash;
+  int count;
+  int i;
+
+  words = dsda_PackGameState(&count);
+  hash = 0x9e3779b97f4a7c15ull * (frame + 1);
+  hash = (hash ^ (unsigned int) player_damage_last_tic) * 0xff51afd7ed558ccdull;
+
+  for (i = 0; i + 2 <= count; i += 2) {
+    hash = (hash ^ (words[i] | (uint64_t) words[i + 1] << 32)) * 0xff51afd7ed558ccdull;
+    hash ^= hash >> 32;
+  }
+
+  if (i < count)
+    hash = (hash ^ words[i]) * 0x100000001b3ull;
+
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ull;
+  hash ^= hash >> 33;
+
+  // 0 marks an empty slot
+  return hash ? hash : 1;
+}
+
+static void dsda_ResetBFStates(void) {
+  if (!bf_state_table) {
+    bf_state_table_size = BF_STATE_TABLE_MIN;
+    bf_state_table = Z_Malloc(bf_state_table_size * sizeof(*bf_state_table));
+  }
+
+  memset(bf_state_table, 0, bf_state_table_size * sizeof(*bf_state_table));
+  bf_state_count = 0;
+}
+
+static uint64_t* dsda_FindBFState(uint64_t hash) {
+  unsigned int mask = bf_state_table_size - 1;
+  unsigned int i = (unsigned int) hash & mask;
+
+  while (bf_state_table[i] && bf_state_table[i] != hash)
+    i = (i + 1) & mask;
+
+  return &bf_state_table[i];
+}
+
+static void dsda_GrowBFStates(void) {
+  uint64_t* old_table = bf_state_table;
+  int old_size = bf_state_table_size;
+  int i;
+
+  bf_state_table_size *= 2;
+  bf_state_table = Z_Calloc(bf_state_table_size, sizeof(*bf_state_table));
+
+  for (i = 0; i < old_size; ++i)
+    if (old_table[i])
+      *dsda_FindBFState(old_table[i]) = old_table[i];
+
+  Z_Free(old_table);
+}
+
+// Records the state at the start of this frame,
+// returning true if an earlier branch already reached it
+static dboolean dsda_BFStateSeen(int frame) {
+  uint64_t hash;
+  uint64_t* slot;
+
+  hash = dsda_BFStateHash(frame);
+  slot = dsda_FindBFState(hash);
+
+  if (*slot)
+    return true;
+
+  // Keep the table at most half full, once it's at the limit new states
+  // are only compared against the ones already stored
+  if (bf_state_count >= bf_state_table_size / 2) {
+    if (bf_state_table_size >= BF_STATE_TABLE_MAX)
+      return false;
+
+    dsda_GrowBFStates();
+    slot = dsda_FindBFState(hash);
+  }
+
+  *slot = hash;
+  ++bf_state_count;
+
+  return false;
+}
+
 static void dsda_PrintBFProgress(void) {
   int percent;
   unsigned long long elapsed_time;
 
+  if (bf_worker)
+    return;
+
   percent = 100 * bf_volume / bf_volume_max;
   elapsed_time = dsda_ElapsedTimeMS(dsda_timer_brute_force);
 
   lprintf(LO_INFO, "  %lld / %lld sequences tested (%d%%) in %.2f seconds!\n",
           bf_volume, bf_volume_max, percent, (float) elapsed_time / 1000);
+
+  if (bf_pruned)
+    lprintf(LO_INFO, "  %lld skipped as duplicate states\n", bf_pruned);
 }
 
 #define BF_FAILURE 0
@@ -240,7 +383,12 @@ dboolean dsda_BruteForceEnded(void) {
   return brute_force_ended;
 }
 
+static void dsda_FinishBFWorker(int result);
+
 static void dsda_EndBF(int result) {
+  if (bf_worker)
+    dsda_FinishBFWorker(result);
+
   brute_force_ended = true;
 
   lprintf(LO_INFO, "Brute force complete (%s)!\n", bf_result_text[result]);
@@ -259,6 +407,14 @@ static void dsda_EndBF(int result) {
     dsda_ExitSkipMode();
 }
 
+// Every sequence was tested without the conditions being reached
+static void dsda_EndBFSearch(void) {
+  if (bf_target.enabled && bf_target.evaluated)
+    dsda_EndBF(BF_SUCCESS);
+  else
+    dsda_EndBF(BF_FAILURE);
+}
+
 static fixed_t dsda_BFAttribute(int attribute) {
   extern int bmapwidth;
 
@@ -386,10 +542,10 @@ static dboolean dsda_BFConditionReached(int i) {
   }
 }
 
+static void dsda_PrintBFBestResult(void);
+
 static void dsda_BFUpdateBestResult(fixed_t value) {
   int i;
-  char str[FIXED_STRING_LENGTH];
-  char cmd_str[COMMAND_MOVEMENT_STRING_LENGTH];
 
   bf_target.evaluated = true;
   bf_target.best_value = value;
@@ -400,6 +556,18 @@ static void dsda_BFUpdateBestResult(fixed_t value) {
 
   dsda_CopyBFResult(bf_target.best_bf, bf_target.best_depth);
 
+  dsda_PrintBFBestResult();
+}
+
+static void dsda_PrintBFBestResult(void) {
+  int i;
+  fixed_t value = bf_target.best_value;
+  char str[FIXED_STRING_LENGTH];
+  char cmd_str[COMMAND_MOVEMENT_STRING_LENGTH];
+
+  if (bf_worker)
+    return;
+
   if (fixed_point_attribute[bf_target.attribute])
     dsda_FixedToString(str, value);
   else
@@ -593,6 +761,230 @@ void dsda_BruteForceWithMonsters(void) {
   bf_nomonsters = false;
 }
 
+#ifndef _WIN32
+
+#define MAX_BF_WORKERS 64
+
+static void dsda_FinishBFWorker(int result) {
+  bf_worker_result_t report;
+  const char* p;
+  size_t left;
+
+  memset(&report, 0, sizeof(report));
+  report.volume = bf_volume - bf_worker_start;
+  report.pruned = bf_pruned;
+  report.success = (result == BF_SUCCESS);
+  report.evaluated = bf_target.evaluated;
+  report.best_value = bf_target.best_value;
+  memcpy(report.result, bf_result, sizeof(report.result));
+
+  p = (const char*) &report;
+  left = sizeof(report);
+  while (left) {
+    ssize_t n = write(bf_worker_fd, p, left);
+
+    if (n < 0 && errno == EINTR)
+      continue;
+
+    if (n <= 0)
+      break;
+
+    p += n;
+    left -= n;
+  }
+
+  // Skip exit handlers, they belong to the parent
+  _exit(0);
+}
+
+static dboolean dsda_ReadBFWorkerResult(int fd, bf_worker_result_t* report) {
+  char* p = (char*) report;
+  size_t left = sizeof(*report);
+
+  while (left) {
+    ssize_t n = read(fd, p, left);
+
+    if (n < 0 && errno == EINTR)
+      continue;
+
+    if (n <= 0)
+      return false;
+
+    p += n;
+    left -= n;
+  }
+
+  return true;
+}
+
+// Sequence index -> range positions, frame bf_depth - 1 being the
+// least significant digit, same order as dsda_AdvanceBruteForce
+static void dsda_SeekBruteForce(long long index) {
+  int i;
+
+  for (i = bf_depth - 1; i >= 0; --i) {
+    bf_range_t* ranges[3];
+    int j;
+
+    ranges[0] = &brute_force[i].angleturn;
+    ranges[1] = &brute_force[i].sidemove;
+    ranges[2] = &brute_force[i].forwardmove;
+
+    for (j = 0; j < 3; ++j) {
+      int count = ranges[j]->max - ranges[j]->min + 1;
+
+      ranges[j]->i = ranges[j]->min + (int) (index % count);
+      index /= count;
+    }
+  }
+}
+
+static void dsda_RunBFWorker(int fd, long long start, long long end) {
+  // Auto key frames are still saved while searching, and the
+  // delta encoder thread didn't come along with the fork
+  dsda_ResetDeltaThreadAfterFork();
+
+  bf_worker = true;
+  bf_worker_fd = fd;
+  bf_worker_start = start;
+  bf_volume = start;
+  bf_volume_max = end;
+
+  dsda_SeekBruteForce(start);
+
+  // dsda_EndBF leaves the process from inside the ticker
+  while (1) {
+    G_Ticker();
+    gametic++;
+  }
+}
+
+// Splits the sequences into contiguous slices, one per worker process.
+// The slices are merged in index order so the outcome matches a search
+// done in a single process: the first success wins, and a target only
+// moves on a strict improvement.
+static dboolean dsda_RunBFWorkers(int workers) {
+  pid_t pid[MAX_BF_WORKERS];
+  int fd[MAX_BF_WORKERS];
+  long long volume = 0;
+  dboolean success = false;
+  dboolean failed = false;
+  int i;
+
+  if (workers > bf_volume_max)
+    workers = (int) bf_volume_max;
+
+  if (workers <= 1)
+    return false;
+
+  // dsda_EndBF restores this frame in the parent
+  dsda_StoreBFKeyFrame(0);
+
+  for (i = 0; i < workers; ++i) {
+    int pipe_fd[2];
+    long long start, end;
+
+    start = (bf_volume_max / workers) * i + MIN(i, bf_volume_max % workers);
+    end = (bf_volume_max / workers) * (i + 1) + MIN(i + 1, bf_volume_max % workers);
+
+    if (pipe(pipe_fd)) {
+      pid[i] = -1;
+    }
+    else {
+      fflush(stdout);
+      fflush(stderr);
+
+      pid[i] = fork();
+
+      if (pid[i] == 0) {
+        int j;
+
+        for (j = 0; j < i; ++j)
+          close(fd[j]);
+        close(pipe_fd[0]);
+
+        dsda_RunBFWorker(pipe_fd[1], start, end);
+      }
+
+      close(pipe_fd[1]);
+      fd[i] = pipe_fd[0];
+
+      if (pid[i] < 0)
+        close(fd[i]);
+    }
+
+    if (pid[i] < 0) {
+      int j;
+
+      lprintf(LO_WARN, "Could not start brute force worker %d, searching in one process\n", i);
+
+      for (j = 0; j < i; ++j) {
+        kill(pid[j], SIGKILL);
+        waitpid(pid[j], NULL, 0);
+        close(fd[j]);
+      }
+
+      return false;
+    }
+  }
+
+  lprintf(LO_INFO, "Searching with %d workers\n\n", workers);
+
+  for (i = 0; i < workers; ++i) {
+    bf_worker_result_t report;
+
+    if (success) {
+      kill(pid[i], SIGKILL);
+    }
+    else if (!dsda_ReadBFWorkerResult(fd[i], &report)) {
+      lprintf(LO_WARN, "Brute force worker %d failed!\n", i);
+      failed = true;
+    }
+    else {
+      volume += report.volume;
+      bf_pruned += report.pruned;
+
+      if (report.success && !bf_target.enabled) {
+        memcpy(bf_result, report.result, sizeof(bf_result));
+        success = true;
+      }
+      else if (report.evaluated && dsda_BFNewBestResult(report.best_value)) {
+        bf_target.evaluated = true;
+        bf_target.best_value = report.best_value;
+        bf_target.best_depth = bf_depth;
+        memcpy(bf_result, report.result, sizeof(bf_result));
+        dsda_PrintBFBestResult();
+      }
+    }
+
+    close(fd[i]);
+    waitpid(pid[i], NULL, 0);
+  }
+
+  bf_volume = volume;
+
+  if (failed)
+    lprintf(LO_WARN, "Warning: part of the search did not complete!\n");
+
+  if (success)
+    dsda_EndBF(BF_SUCCESS);
+  else
+    dsda_EndBFSearch();
+
+  return true;
+}
+
+#else
+
+static void dsda_FinishBFWorker(int result) {
+}
+
+static dboolean dsda_RunBFWorkers(int workers) {
+  return false;
+}
+
+#endif
+
 dboolean dsda_StartBruteForce(int depth) {
   int i;
 
@@ -612,6 +1004,9 @@ dboolean dsda_StartBruteForce(int depth) {
   bf_logictic = true_logictic;
   bf_volume = 0;
   bf_volume_max = 1;
+  bf_pruned = 0;
+  bf_next_progress = 0;
+  bf_exhausted = false;
 
   for (i = 0; i < bf_depth; ++i) {
     lprintf(LO_INFO, "  %d: F %d:%d S %d:%d T %d:%d B %d\n", i,
@@ -629,6 +1024,15 @@ dboolean dsda_StartBruteForce(int depth) {
     brute_force[i].angleturn.i = brute_force[i].angleturn.min;
   }
 
+  bf_subtree_volume[bf_depth] = 1;
+  for (i = bf_depth - 1; i >= 0; --i)
+    bf_subtree_volume[i] = bf_subtree_volume[i + 1] *
+                           (brute_force[i].forwardmove.max - brute_force[i].forwardmove.min + 1) *
+                           (brute_force[i].sidemove.max - brute_force[i].sidemove.min + 1) *
+                           (brute_force[i].angleturn.max - brute_force[i].angleturn.min + 1);
+
+  dsda_ResetBFStates();
+
   lprintf(LO_INFO, "Testing %lld sequences with depth %d\n\n", bf_volume_max, bf_depth);
 
   bf_mode = true;
@@ -643,6 +1047,8 @@ dboolean dsda_StartBruteForce(int depth) {
 
   dsda_StartTimer(dsda_timer_brute_force);
 
+  dsda_RunBFWorkers(dsda_IntConfig(dsda_config_brute_force_workers));
+
   return true;
 }
 
@@ -652,19 +1058,47 @@ void dsda_UpdateBruteForce(void) {
   frame = true_logictic - bf_logictic;
 
   if (frame == bf_depth) {
-    if (bf_volume % 10000 == 0)
+    if (bf_volume >= bf_next_progress) {
       dsda_PrintBFProgress();
+      bf_next_progress = bf_volume - bf_volume % 10000 + 10000;
+    }
 
-    frame = dsda_AdvanceBruteForce();
+    frame = dsda_AdvanceBruteForce(bf_depth - 1);
 
     if (frame >= 0)
       dsda_RestoreBFKeyFrame(frame);
   }
-  else
+  else {
     dsda_StoreBFKeyFrame(frame);
+
+    // The later frames are all at their first value here,
+    // so the whole subtree below this frame can be counted off
+    if (frame > 0 && dsda_BFStateSeen(frame)) {
+      long long skipped;
+
+      skipped = MIN(bf_subtree_volume[frame], bf_volume_max - bf_volume);
+      bf_volume += skipped;
+      bf_pruned += skipped;
+
+      if (bf_volume < bf_volume_max)
+        frame = dsda_AdvanceBruteForce(frame - 1);
+      else
+        frame = -1;
+
+      if (frame >= 0)
+        dsda_RestoreBFKeyFrame(frame);
+      else
+        bf_exhausted = true;
+    }
+  }
 }
 
 void dsda_EvaluateBruteForce(void) {
+  if (bf_exhausted) {
+    dsda_EndBFSearch();
+    return;
+  }
+
   if (true_logictic - bf_logictic != bf_depth)
     return;
 
@@ -674,12 +1108,8 @@ void dsda_EvaluateBruteForce(void) {
     dsda_CopyBFResult(brute_force, bf_depth);
     dsda_EndBF(BF_SUCCESS);
   }
-  else if (bf_volume >= bf_volume_max) {
-    if (bf_target.enabled && bf_target.evaluated)
-      dsda_EndBF(BF_SUCCESS);
-    else
-      dsda_EndBF(BF_FAILURE);
-  }
+  else if (bf_volume >= bf_volume_max)
+    dsda_EndBFSearch();
 }
 
 void dsda_CopyBruteForceCommand(ticcmd_t* cmd) {
@@ -787,12 +787,16 @@ dsda_config_t dsda_config[dsda_config_count] = {
   },
   [dsda_config_cap_videocommand] = {
     "cap_videocommand", dsda_config_cap_videocommand,
-    CONF_STRING("ffmpeg -f rawvideo -pix_fmt rgb24 -r %r -s %wx%h -i - -c:v libx264 -y temp_v.nut")
+    CONF_STRING("ffmpeg -f rawvideo -pix_fmt %p -r %r -s %wx%h -i - -c:v libx264 -y temp_v.nut")
   },
   [dsda_config_cap_muxcommand] = {
     "cap_muxcommand", dsda_config_cap_muxcommand,
     CONF_STRING("ffmpeg -i temp_v.nut -i temp_a.nut -c copy -y %f")
   },
+  [dsda_config_cap_concatcommand] = {
+    "cap_concatcommand", dsda_config_cap_concatcommand,
+    CONF_STRING("ffmpeg -f concat -safe 0 -i %l -c copy -y %f")
+  },
   [dsda_config_cap_tempfile1] = {
     "cap_tempfile1", dsda_config_cap_tempfile1,
     CONF_STRING("temp_a.nut")
@@ -813,6 +817,34 @@ dsda_config_t dsda_config[dsda_config_count] = {
     "cap_fps", dsda_config_cap_fps,
     dsda_config_int, 16, 300, { 60 }
   },
+  [dsda_config_cap_queue_frames] = {
+    "cap_queue_frames", dsda_config_cap_queue_frames,
+    dsda_config_int, 1, 64, { 4 }
+  },
+  [dsda_config_cap_direct_format] = {
+    "cap_direct_format", dsda_config_cap_direct_format,
+    dsda_config_int, 0, 2, { 0 }
+  },
+  [dsda_config_cap_direct_scale] = {
+    "cap_direct_scale", dsda_config_cap_direct_scale,
+    dsda_config_int, 1, 8, { 1 }
+  },
+  [dsda_config_cap_builtin_encoder] = {
+    "cap_builtin_encoder", dsda_config_cap_builtin_encoder,
+    CONF_BOOL(0)
+  },
+  [dsda_config_cap_video_codec] = {
+    "cap_video_codec", dsda_config_cap_video_codec,
+    CONF_STRING("libx264")
+  },
+  [dsda_config_cap_video_options] = {
+    "cap_video_options", dsda_config_cap_video_options,
+    CONF_STRING("preset=veryfast:crf=18")
+  },
+  [dsda_config_cap_audio_codec] = {
+    "cap_audio_codec", dsda_config_cap_audio_codec,
+    CONF_STRING("libopus")
+  },
   [dsda_config_hudadd_crosshair_color] = {
     "hudadd_crosshair_color", dsda_config_hudadd_crosshair_color,
     CONF_CR(3)
@@ -883,12 +915,24 @@ dsda_config_t dsda_config[dsda_config_count] = {
   },
   [dsda_config_auto_key_frame_depth] = {
     "dsda_auto_key_frame_depth", dsda_config_auto_key_frame_depth,
-    dsda_config_int, 0, 600, { 60 }, NULL, STRICT_INT(0), dsda_InitKeyFrame
+    dsda_config_int, 0, 3600, { 60 }, NULL, STRICT_INT(0), dsda_InitKeyFrame
   },
   [dsda_config_auto_key_frame_timeout] = {
     "dsda_auto_key_frame_timeout", dsda_config_auto_key_frame_timeout,
     dsda_config_int, 0, 25, { 10 }, NULL, NOT_STRICT, dsda_InitKeyFrame
   },
+  [dsda_config_auto_key_frame_full_interval] = {
+    "dsda_auto_key_frame_full_interval", dsda_config_auto_key_frame_full_interval,
+    dsda_config_int, 1, 600, { 30 }, NULL, NOT_STRICT, dsda_InitKeyFrame
+  },
+  [dsda_config_demo_seek_index_interval] = {
+    "dsda_demo_seek_index_interval", dsda_config_demo_seek_index_interval,
+    dsda_config_int, 0, 600, { 0 }
+  },
+  [dsda_config_brute_force_workers] = {
+    "dsda_brute_force_workers", dsda_config_brute_force_workers,
+    dsda_config_int, 1, 64, { 1 }
+  },
   [dsda_config_ex_text_scale_x] = {
     "ex_text_scale_x", dsda_config_ex_text_scale_x,
     dsda_config_int, 0, 4000, { 0 }, NULL, NOT_STRICT, dsda_SetupStretchParams
@@ -1134,6 +1178,10 @@ dsda_config_t dsda_config[dsda_config_count] = {
     "render_doom_lightmaps", dsda_config_render_doom_lightmaps,
     CONF_BOOL(0)
   },
+  [dsda_config_render_threads] = {
+    "render_threads", dsda_config_render_threads,
+    dsda_config_int, 1, 64, { 1 }
+  },
   [dsda_config_fake_contrast_mode] = {
     "fake_contrast_mode", dsda_config_fake_contrast_mode,
     dsda_config_int, FAKE_CONTRAST_MODE_OFF, FAKE_CONTRAST_MODE_SMOOTH,
@@ -169,11 +169,19 @@ typedef enum {
   dsda_config_cap_soundcommand,
   dsda_config_cap_videocommand,
   dsda_config_cap_muxcommand,
+  dsda_config_cap_concatcommand,
   dsda_config_cap_tempfile1,
   dsda_config_cap_tempfile2,
   dsda_config_cap_remove_tempfiles,
   dsda_config_cap_wipescreen,
   dsda_config_cap_fps,
+  dsda_config_cap_queue_frames,
+  dsda_config_cap_direct_format,
+  dsda_config_cap_direct_scale,
+  dsda_config_cap_builtin_encoder,
+  dsda_config_cap_video_codec,
+  dsda_config_cap_video_options,
+  dsda_config_cap_audio_codec,
   dsda_config_hudadd_crosshair_color,
   dsda_config_hudadd_crosshair_target_color,
   dsda_config_hud_displayed,
@@ -193,6 +201,9 @@ typedef enum {
   dsda_config_auto_key_frame_interval,
   dsda_config_auto_key_frame_depth,
   dsda_config_auto_key_frame_timeout,
+  dsda_config_auto_key_frame_full_interval,
+  dsda_config_demo_seek_index_interval,
+  dsda_config_brute_force_workers,
   dsda_config_ex_text_scale_x,
   dsda_config_ex_text_ratio_y,
   dsda_config_wipe_at_full_speed,
@@ -254,6 +265,7 @@ typedef enum {
   dsda_config_integer_scaling,
   dsda_config_render_aspect,
   dsda_config_render_doom_lightmaps,
+  dsda_config_render_threads,
   dsda_config_fake_contrast_mode,
   dsda_config_render_stretch_hud,
   dsda_config_render_patches_scalex,
@@ -0,0 +1,421 @@
+//
+// Copyright(C) 2026 by borogk
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//	DSDA Demo Batch
+//
+//  With -playdemo_batch, this process loads the wads once and then
+//  forks a worker per demo in the list, so the setup is shared.
+//  Each worker plays its demo without drawing or sound in its own
+//  directory, and the parent gathers its analysis.txt, levelstat.txt
+//  and errors into one JSON line per demo, in list order.
+//
+
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#endif
+
+#include "SDL.h"
+
+#include "doomstat.h"
+#include "e6y.h"
+#include "g_game.h"
+#include "i_main.h"
+#include "i_system.h"
+#include "lprintf.h"
+#include "m_file.h"
+#include "z_zone.h"
+
+#include "dsda/analysis.h"
+#include "dsda/args.h"
+#include "dsda/playback.h"
+#include "dsda/utility.h"
+
+#include "demo_batch.h"
+
+// Set in the forked processes that play the demos
+static dboolean batch_worker;
+
+void dsda_InitDemoBatch(void) {
+  if (!dsda_Flag(dsda_arg_playdemo_batch))
+    return;
+
+  dsda_UpdateFlag(dsda_arg_nodraw, true);
+  dsda_UpdateFlag(dsda_arg_nosound, true);
+  fastdemo = true;
+}
+
+#ifdef _WIN32
+
+void dsda_RunDemoBatch(void) {
+  I_Error("dsda_RunDemoBatch: -playdemo_batch is not supported on this platform");
+}
+
+void dsda_ExitBatchWorker(int rc) {
+}
+
+#else
+
+// The exit handlers belong to the parent: a worker must not save the
+// config, show ENDOOM or clean up the shared zip directories.
+// Its result is the exit code plus the files left in its directory.
+void dsda_ExitBatchWorker(int rc) {
+  if (!batch_worker)
+    return;
+
+  dsda_WriteAnalysis();
+
+  fflush(stdout);
+  fflush(stderr);
+
+  _exit(rc);
+}
+
+typedef struct {
+  char* name;
+  char* path;
+  char* dir;
+  pid_t pid;
+  char* result;
+  dboolean failed;
+} batch_demo_t;
+
+static batch_demo_t* batch_demos;
+static int batch_demo_count;
+static char* batch_work_dir;
+
+static void dsda_StripCarriageReturn(char* line) {
+  size_t length = strlen(line);
+
+  if (length && line[length - 1] == '\r')
+    line[length - 1] = '\0';
+}
+
+static void dsda_JSONString(dsda_string_t* str, const char* value) {
+  const char* p;
+
+  dsda_StringCat(str, "\"");
+
+  for (p = value; *p; ++p) {
+    unsigned char c = *p;
+
+    if (c == '"' || c == '\\')
+      dsda_StringCatF(str, "\\%c", c);
+    else if (c == '\n')
+      dsda_StringCat(str, "\\n");
+    else if (c == '\t')
+      dsda_StringCat(str, "\\t");
+    else if (c < 0x20)
+      dsda_StringCatF(str, "\\u%04x", c);
+    else
+      dsda_StringCatF(str, "%c", c);
+  }
+
+  dsda_StringCat(str, "\"");
+}
+
+static char* dsda_ReadBatchFile(const batch_demo_t* demo, const char* name) {
+  char* path;
+  char* buffer = NULL;
+
+  path = Z_Malloc(strlen(demo->dir) + strlen(name) + 2);
+  sprintf(path, "%s/%s", demo->dir, name);
+
+  if (M_ReadFileToString(path, &buffer) < 0)
+    buffer = NULL;
+
+  M_remove(path);
+  Z_Free(path);
+
+  return buffer;
+}
+
+// analysis.txt is "key value" lines, numbers are written unquoted
+static void dsda_AppendAnalysis(dsda_string_t* str, char* analysis) {
+  char** lines;
+  int i;
+  dboolean first = true;
+
+  dsda_StringCat(str, ", \"analysis\": {");
+
+  lines = dsda_SplitString(analysis, "\n");
+  for (i = 0; lines[i]; ++i) {
+    char* value;
+    int number, length;
+
+    dsda_StripCarriageReturn(lines[i]);
+
+    value = strchr(lines[i], ' ');
+    if (!value)
+      continue;
+
+    *value++ = '\0';
+
+    if (!first)
+      dsda_StringCat(str, ", ");
+    first = false;
+
+    dsda_JSONString(str, lines[i]);
+    dsda_StringCat(str, ": ");
+
+    if (sscanf(value, "%d%n", &number, &length) == 1 && !value[length])
+      dsda_StringCatF(str, "%d", number);
+    else
+      dsda_JSONString(str, value);
+  }
+  Z_Free(lines);
+
+  dsda_StringCat(str, "}");
+}
+
+static void dsda_AppendLevelStat(dsda_string_t* str, char* levelstat) {
+  char** lines;
+  int i;
+  dboolean first = true;
+
+  dsda_StringCat(str, ", \"levelstat\": [");
+
+  lines = dsda_SplitString(levelstat, "\n");
+  for (i = 0; lines[i]; ++i) {
+    dsda_StripCarriageReturn(lines[i]);
+
+    if (!lines[i][0])
+      continue;
+
+    if (!first)
+      dsda_StringCat(str, ", ");
+    first = false;
+
+    dsda_JSONString(str, lines[i]);
+  }
+  Z_Free(lines);
+
+  dsda_StringCat(str, "]");
+}
+
+static void dsda_FinishBatchDemo(batch_demo_t* demo, int status) {
+  dsda_string_t str;
+  char* text;
+
+  dsda_InitString(&str, "{\"demo\": ");
+  dsda_JSONString(&str, demo->name);
+
+  if (!demo->path)
+    dsda_StringCat(&str, ", \"status\": \"missing\"");
+  else if (WIFEXITED(status))
+    dsda_StringCatF(&str, ", \"status\": %d", WEXITSTATUS(status));
+  else
+    dsda_StringCatF(&str, ", \"status\": \"signal %d\"", WTERMSIG(status));
+
+  demo->failed = !demo->path || !WIFEXITED(status) || WEXITSTATUS(status);
+
+  if (demo->dir) {
+    if ((text = dsda_ReadBatchFile(demo, "analysis.txt"))) {
+      dsda_AppendAnalysis(&str, text);
+      Z_Free(text);
+    }
+
+    if ((text = dsda_ReadBatchFile(demo, "levelstat.txt"))) {
+      dsda_AppendLevelStat(&str, text);
+      Z_Free(text);
+    }
+
+    // I_Error messages end up on stderr
+    if ((text = dsda_ReadBatchFile(demo, "stderr.txt"))) {
+      if (text[0]) {
+        dsda_StringCat(&str, ", \"error\": ");
+        dsda_JSONString(&str, text);
+      }
+      Z_Free(text);
+    }
+
+    text = dsda_ReadBatchFile(demo, "stdout.txt");
+    Z_Free(text);
+    M_remove(demo->dir);
+  }
+
+  dsda_StringCat(&str, "}\n");
+  demo->result = str.string;
+}
+
+static void dsda_LoadBatchList(const char* list_name) {
+  char* buffer;
+  char** lines;
+  char cwd[PATH_MAX];
+  int i;
+
+  if (M_ReadFileToString(list_name, &buffer) < 0)
+    I_Error("dsda_LoadBatchList: unable to read %s", list_name);
+
+  if (!M_getcwd(cwd, sizeof(cwd)))
+    I_Error("dsda_LoadBatchList: unable to get the working directory");
+
+  lines = dsda_SplitString(buffer, "\n");
+  for (i = 0; lines[i]; ++i) {
+    batch_demo_t* demo;
+    char* path;
+
+    dsda_StripCarriageReturn(lines[i]);
+
+    // blank lines and # comments are skipped
+    if (!lines[i][0] || lines[i][0] == '#')
+      continue;
+
+    batch_demos = Z_Realloc(batch_demos, (batch_demo_count + 1) * sizeof(*batch_demos));
+    demo = &batch_demos[batch_demo_count++];
+    memset(demo, 0, sizeof(*demo));
+
+    demo->name = Z_Strdup(lines[i]);
+
+    // workers run in their own directory, so the path has to be absolute
+    path = I_FindFile(lines[i], ".lmp");
+    if (path && path[0] != '/') {
+      demo->path = Z_Malloc(strlen(cwd) + strlen(path) + 2);
+      sprintf(demo->path, "%s/%s", cwd, path);
+      Z_Free(path);
+    }
+    else
+      demo->path = path;
+  }
+
+  Z_Free(lines);
+  Z_Free(buffer);
+}
+
+static void dsda_StartBatchDemo(batch_demo_t* demo, int index) {
+  demo->dir = Z_Malloc(strlen(batch_work_dir) + 16);
+  sprintf(demo->dir, "%s/%d", batch_work_dir, index);
+  M_MakeDir(demo->dir, true);
+
+  fflush(stdout);
+  fflush(stderr);
+
+  demo->pid = fork();
+
+  if (demo->pid == -1)
+    I_Error("dsda_StartBatchDemo: unable to start a worker for %s", demo->name);
+
+  if (!demo->pid) {
+    if (chdir(demo->dir) ||
+        !freopen("stdout.txt", "w", stdout) ||
+        !freopen("stderr.txt", "w", stderr))
+      _exit(1);
+
+    batch_worker = true;
+
+    dsda_analysis = true;
+    stats_level = true;
+
+    G_DeferedPlayDemo(demo->path);
+    userdemo = true;
+  }
+}
+
+void dsda_RunDemoBatch(void) {
+  const char* list_name;
+  char* report_name;
+  FILE* report;
+  int jobs, running = 0;
+  int next = 0, written = 0, failed = 0;
+
+  list_name = dsda_Arg(dsda_arg_playdemo_batch)->value.v_string;
+  dsda_LoadBatchList(list_name);
+
+  report_name = Z_Malloc(strlen(list_name) + sizeof(".jsonl"));
+  strcpy(report_name, list_name);
+  dsda_CutExtension(report_name);
+  strcat(report_name, ".jsonl");
+
+  report = M_OpenFile(report_name, "w");
+  if (!report)
+    I_Error("dsda_RunDemoBatch: unable to open %s", report_name);
+
+  batch_work_dir = Z_Malloc(strlen(report_name) + sizeof(".work"));
+  sprintf(batch_work_dir, "%s.work", report_name);
+  M_MakeDir(batch_work_dir, true);
+
+  jobs = dsda_Flag(dsda_arg_playdemo_batch_jobs) ?
+         dsda_SimpleIntArg(dsda_arg_playdemo_batch_jobs) : SDL_GetCPUCount();
+  jobs = MAX(jobs, 1);
+
+  lprintf(LO_INFO, "dsda_RunDemoBatch: playing %d demos with %d workers\n", batch_demo_count, jobs);
+
+  while (written < batch_demo_count) {
+    int status;
+    pid_t pid;
+    int i;
+
+    while (running < jobs && next < batch_demo_count) {
+      batch_demo_t* demo = &batch_demos[next];
+
+      if (!demo->path) {
+        dsda_FinishBatchDemo(demo, 0);
+        ++next;
+        continue;
+      }
+
+      dsda_StartBatchDemo(demo, next);
+
+      // this is the worker, go play the demo
+      if (!demo->pid)
+        return;
+
+      ++running;
+      ++next;
+    }
+
+    if (running) {
+      pid = waitpid(-1, &status, 0);
+
+      if (pid == -1)
+        I_Error("dsda_RunDemoBatch: lost track of the workers");
+
+      for (i = 0; i < next; ++i)
+        if (batch_demos[i].pid == pid && !batch_demos[i].result) {
+          dsda_FinishBatchDemo(&batch_demos[i], status);
+          --running;
+          break;
+        }
+    }
+
+    // results are written in list order as soon as they are known
+    for (; written < next && batch_demos[written].result; ++written) {
+      batch_demo_t* demo = &batch_demos[written];
+
+      if (demo->failed)
+        ++failed;
+
+      fputs(demo->result, report);
+      fflush(report);
+    }
+  }
+
+  fclose(report);
+  M_remove(batch_work_dir);
+
+  lprintf(LO_INFO, "dsda_RunDemoBatch: %d of %d demos failed, results in %s\n",
+          failed, batch_demo_count, report_name);
+
+  // nothing was played in this process
+  dsda_analysis = false;
+
+  I_SafeExit(failed ? 1 : 0);
+}
+
+#endif
@@ -30,10 +30,11 @@ static local_component_t* local;
 static void dsda_UpdateCurrentComponentText(char* str, size_t max_size) {
   extern dsda_render_stats_t dsda_render_stats;
   extern int dsda_render_stats_fps;
+  extern int dsda_render_stats_bsp_cache_rate;
 
   snprintf(
     str, max_size,
-    "%sFPS %s%4d %sSEGS %s%4d %sPLANES %s%4d %sSPRITES %s%4d",
+    "%sFPS %s%4d %sSEGS %s%4d %sPLANES %s%4d %sSPRITES %s%4d %sBSP %s%3d%%",
     dsda_TextColor(dsda_tc_exhud_render_label),
     dsda_render_stats_fps < 35 ? dsda_TextColor(dsda_tc_exhud_render_bad) :
                                  dsda_TextColor(dsda_tc_exhud_render_good),
@@ -49,7 +50,10 @@ static void dsda_UpdateCurrentComponentText(char* str, size_t max_size) {
     dsda_TextColor(dsda_tc_exhud_render_label),
     dsda_render_stats.vissprites > 128 ? dsda_TextColor(dsda_tc_exhud_render_bad) :
                                          dsda_TextColor(dsda_tc_exhud_render_good),
-    dsda_render_stats.vissprites
+    dsda_render_stats.vissprites,
+    dsda_TextColor(dsda_tc_exhud_render_label),
+    dsda_TextColor(dsda_tc_exhud_render_good),
+    dsda_render_stats_bsp_cache_rate
   );
 }
 
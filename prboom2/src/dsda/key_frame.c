@@ -40,11 +40,13 @@
 #include "dsda/configuration.h"
 #include "dsda/demo.h"
 #include "dsda/features.h"
+#include "dsda/key_frame_delta.h"
 #include "dsda/mapinfo.h"
 #include "dsda/options.h"
 #include "dsda/pause.h"
 #include "dsda/playback.h"
 #include "dsda/save.h"
+#include "dsda/seek_index.h"
 #include "dsda/settings.h"
 #include "dsda/time.h"
 
@@ -66,6 +68,14 @@ static int restore_key_frame_index = -1;
 static int dsda_auto_key_frame_interval;
 static int dsda_auto_key_frame_depth;
 static int dsda_auto_key_frame_timeout;
+static int dsda_auto_key_frame_full_interval;
+
+static int auto_kf_serial;
+static auto_kf_t* encoding_auto_kf;
+static byte* delta_source;
+static byte* delta_reference;
+static int delta_reference_length;
+static int delta_reference_serial;
 
 static int autoKeyFrameTimeout(void) {
   return dsda_StartInBuildMode() ? 0 : dsda_auto_key_frame_timeout;
@@ -96,20 +106,20 @@ void dsda_ForgetAutoKeyFrames(void) {
 
 static void dsda_ResetParentKF(dsda_key_frame_t* kf) {
   kf->parent.auto_kf = NULL;
-  kf->parent.buffer = NULL;
+  kf->parent.serial = 0;
 }
 
 static void dsda_AttachAutoKF(dsda_key_frame_t* kf) {
   if (autoKFExists(last_auto_kf)) {
     kf->parent.auto_kf = last_auto_kf;
-    kf->parent.buffer = last_auto_kf->kf.buffer;
+    kf->parent.serial = last_auto_kf->serial;
   }
   else
     dsda_ResetParentKF(kf);
 }
 
 static void dsda_ResolveParentKF(dsda_key_frame_t* kf) {
-  if (autoKFExists(kf->parent.auto_kf) && kf->parent.auto_kf->kf.buffer == kf->parent.buffer)
+  if (autoKFExists(kf->parent.auto_kf) && kf->parent.auto_kf->serial == kf->parent.serial)
     last_auto_kf = kf->parent.auto_kf;
   else {
     dsda_ResetParentKF(kf);
@@ -130,35 +140,58 @@ static void dsda_RewindKF(auto_kf_t** current) {
     *current = NULL;
 }
 
-static dsda_key_frame_t* dsda_ClosestKeyFrame(int target_tic_count) {
+// Walks back to the full frame a delta chain starts from, or NULL if it was overwritten
+static auto_kf_t* dsda_AutoKFBase(auto_kf_t* auto_kf) {
+  while (auto_kf->chain) {
+    auto_kf_t* prev = auto_kf->prev;
+
+    if (!autoKFExists(prev) || prev->serial != auto_kf->ref_serial)
+      return NULL;
+
+    auto_kf = prev;
+  }
+
+  return auto_kf;
+}
+
+static dsda_key_frame_t* dsda_ClosestKeyFrame(int target_tic_count, auto_kf_t** closest_auto_kf) {
   dsda_key_frame_t* closest = NULL;
 
+  *closest_auto_kf = NULL;
+
   if (last_auto_kf) {
     auto_kf_t* auto_kf;
 
     auto_kf = last_auto_kf;
     for (auto_kf = last_auto_kf; auto_kf && auto_kf->kf.buffer; dsda_RewindKF(&auto_kf))
-      if (auto_kf->kf.game_tic_count <= target_tic_count)
+      if (auto_kf->kf.game_tic_count <= target_tic_count && dsda_AutoKFBase(auto_kf))
         if (!closest || auto_kf->kf.game_tic_count > closest->game_tic_count) {
           closest = &auto_kf->kf;
+          *closest_auto_kf = auto_kf;
           break;
         }
   }
 
   if (!demorecording && temp_kf.buffer)
     if (temp_kf.game_tic_count <= target_tic_count)
-      if (!closest || temp_kf.game_tic_count > closest->game_tic_count)
+      if (!closest || temp_kf.game_tic_count > closest->game_tic_count) {
         closest = &temp_kf;
+        *closest_auto_kf = NULL;
+      }
 
   if (!demorecording && quick_kf.buffer)
     if (quick_kf.game_tic_count <= target_tic_count)
-      if (!closest || quick_kf.game_tic_count > closest->game_tic_count)
+      if (!closest || quick_kf.game_tic_count > closest->game_tic_count) {
         closest = &quick_kf;
+        *closest_auto_kf = NULL;
+      }
 
   if (first_kf.buffer)
     if (first_kf.game_tic_count <= target_tic_count)
-      if (!closest || first_kf.game_tic_count > closest->game_tic_count)
+      if (!closest || first_kf.game_tic_count > closest->game_tic_count) {
         closest = &first_kf;
+        *closest_auto_kf = NULL;
+      }
 
   return closest;
 }
@@ -169,12 +202,122 @@ void dsda_CopyKeyFrame(dsda_key_frame_t* dest, dsda_key_frame_t* source) {
   memcpy(dest->buffer, source->buffer, dest->buffer_length);
 }
 
+// Picks up the encoded auto key frame from the worker
+static void dsda_FinishAutoKeyFrame(void) {
+  int length;
+
+  if (!encoding_auto_kf)
+    return;
+
+  length = dsda_FinishDeltaJob();
+
+  encoding_auto_kf->kf.buffer = Z_Realloc(encoding_auto_kf->kf.buffer, MAX(length, 1));
+  encoding_auto_kf->kf.buffer_length = length;
+
+  // The next auto key frame is encoded against this one
+  if (delta_reference)
+    Z_Free(delta_reference);
+
+  delta_reference = delta_source;
+  delta_reference_length = encoding_auto_kf->length;
+  delta_reference_serial = encoding_auto_kf->serial;
+
+  delta_source = NULL;
+  encoding_auto_kf = NULL;
+}
+
+// Hands the freshly stored auto key frame over to the worker for encoding
+static void dsda_EncodeAutoKeyFrame(auto_kf_t* auto_kf) {
+  auto_kf_t* prev;
+  int chain_limit;
+  dboolean full;
+
+  prev = auto_kf->prev;
+
+  // Keep the whole delta chain inside the ring
+  chain_limit = MIN(dsda_auto_key_frame_full_interval, auto_kf_size - 2);
+
+  full =
+    !delta_reference ||
+    !autoKFExists(prev) ||
+    auto_kf->auto_index != prev->auto_index + 1 ||
+    prev->serial != delta_reference_serial ||
+    prev->chain + 1 >= chain_limit;
+
+  auto_kf->ref_serial = full ? 0 : prev->serial;
+  auto_kf->chain = full ? 0 : prev->chain + 1;
+  auto_kf->length = auto_kf->kf.buffer_length;
+
+  delta_source = auto_kf->kf.buffer;
+  auto_kf->kf.buffer = Z_Malloc(dsda_DeltaBound(auto_kf->length));
+  encoding_auto_kf = auto_kf;
+
+  dsda_StartDeltaJob(auto_kf->kf.buffer, delta_source, auto_kf->length,
+                     full ? NULL : delta_reference, delta_reference_length);
+}
+
+static dboolean dsda_RestoreAutoKeyFrame(auto_kf_t* auto_kf, dboolean skip_wipe) {
+  dsda_key_frame_t key_frame;
+  auto_kf_t* link;
+  byte* buffer = NULL;
+  int length = 0;
+  int i;
+
+  dsda_FinishAutoKeyFrame();
+
+  if (!dsda_AutoKFBase(auto_kf))
+    return false;
+
+  // Decode from the full frame forward
+  for (i = auto_kf->chain; i >= 0; --i) {
+    byte* decoded;
+    int j;
+
+    link = auto_kf;
+    for (j = 0; j < i; ++j)
+      link = link->prev;
+
+    decoded = Z_Malloc(MAX(link->length, 1));
+    dsda_DecodeDelta(decoded, link->length, link->kf.buffer, link->kf.buffer_length, buffer, length);
+
+    if (buffer)
+      Z_Free(buffer);
+
+    buffer = decoded;
+    length = link->length;
+  }
+
+  key_frame = auto_kf->kf;
+  key_frame.buffer = buffer;
+  key_frame.buffer_length = length;
+
+  dsda_RestoreKeyFrame(&key_frame, skip_wipe);
+
+  // Recording continues after this key frame, so encode the next one against it
+  if (delta_reference)
+    Z_Free(delta_reference);
+
+  delta_reference = buffer;
+  delta_reference_length = length;
+  delta_reference_serial = auto_kf->serial;
+
+  return true;
+}
+
 void dsda_InitKeyFrame(void) {
   int i;
 
+  dsda_FinishAutoKeyFrame();
+
+  if (delta_reference) {
+    Z_Free(delta_reference);
+    delta_reference = NULL;
+  }
+
   dsda_auto_key_frame_interval = dsda_IntConfig(dsda_config_auto_key_frame_interval);
   dsda_auto_key_frame_depth = dsda_IntConfig(dsda_config_auto_key_frame_depth);
   dsda_auto_key_frame_timeout = dsda_IntConfig(dsda_config_auto_key_frame_timeout);
+  dsda_auto_key_frame_full_interval = dsda_IntConfig(dsda_config_auto_key_frame_full_interval);
 
   auto_kf_size = autoKeyFrameDepth();
 
@@ -217,6 +360,11 @@ void dsda_ExportKeyFrame(byte* buffer, int length) {
     I_Error("dsda_ExportKeyFrame: Failed to write key frame.");
 }
 
+void dsda_WriteKeyFrame(dsda_key_frame_t* key_frame, const char* name) {
+  if (!M_WriteFile(name, key_frame->buffer, key_frame->buffer_length))
+    I_Error("dsda_WriteKeyFrame: Failed to write key frame %s.", name);
+}
+
 // Stripped down version of G_DoSaveGame
 void dsda_StoreKeyFrame(dsda_key_frame_t* key_frame, byte complete, byte export) {
   key_frame->game_tic_count = true_logictic;
@@ -232,6 +380,9 @@ void dsda_StoreKeyFrame(dsda_key_frame_t* key_frame, byte complete, byte export)
   // Store state of demo recording buffer
   dsda_StoreDemoData(complete);
 
+  // Everything past this point is world state
+  key_frame->archive_offset = save_p - savebuffer;
+
   dsda_ArchiveAll();
 
   if (key_frame->buffer != NULL) Z_Free(key_frame->buffer);
@@ -307,18 +458,30 @@ void dsda_RestoreQuickKeyFrame(void) {
 
 dboolean dsda_RestoreClosestKeyFrame(int tic) {
   dsda_key_frame_t* key_frame;
+  auto_kf_t* auto_kf;
+  int index_tic;
 
-  key_frame = dsda_ClosestKeyFrame(tic);
+  key_frame = dsda_ClosestKeyFrame(tic, &auto_kf);
+  index_tic = dsda_SeekIndexClosestTic(tic);
+
+  if (index_tic >= 0 && (!key_frame || index_tic > key_frame->game_tic_count)) {
+    dsda_RestoreSeekIndexKeyFrame(index_tic);
+
+    return true;
+  }
 
   if (!key_frame)
     return false;
 
+  if (auto_kf)
+    return dsda_RestoreAutoKeyFrame(auto_kf, true);
+
   dsda_RestoreKeyFrame(key_frame, true);
 
   return true;
 }
 
-void dsda_RestoreKeyFrameFile(const char* name) {
+void dsda_RestoreKeyFrameFile(const char* name, dboolean skip_wipe) {
   char *filename;
   dsda_key_frame_t key_frame = { 0 };
 
@@ -326,7 +489,7 @@ void dsda_RestoreKeyFrameFile(const char* name) {
   M_ReadFile(filename, &key_frame.buffer);
   Z_Free(filename);
 
-  dsda_RestoreKeyFrame(&key_frame, false);
+  dsda_RestoreKeyFrame(&key_frame, skip_wipe);
   Z_Free(key_frame.buffer);
 }
 
@@ -335,7 +498,21 @@ void dsda_ContinueKeyFrame(void) {
 
   arg = dsda_Arg(dsda_arg_from_key_frame);
   if (arg->found) {
-    dsda_RestoreKeyFrameFile(arg->value.v_string);
+    dsda_RestoreKeyFrameFile(arg->value.v_string, false);
+  }
+}
+
+// Playback continues from a key frame exported by another process
+void dsda_ContinuePlaybackKeyFrame(void) {
+  dsda_arg_t* arg;
+
+  // -recordfromto continues through dsda_ContinueKeyFrame
+  if (demorecording)
+    return;
+
+  arg = dsda_Arg(dsda_arg_from_key_frame);
+  if (arg->found) {
+    dsda_RestoreKeyFrameFile(arg->value.v_string, true);
   }
 }
 
@@ -345,9 +522,7 @@ void dsda_RewindAutoKeyFrame(void) {
   load_kf = last_auto_kf;
   dsda_RewindKF(&load_kf);
 
-  if (load_kf)
-    dsda_RestoreKeyFrame(&load_kf->kf, true);
-  else
+  if (!load_kf || !dsda_RestoreAutoKeyFrame(load_kf, true))
     doom_printf("No key frame found"); // rewind past the depth limit
 }
 
@@ -385,6 +560,7 @@ void dsda_UpdateAutoKeyFrames(void) {
     last_auto_kf = last_auto_kf->next;
     last_auto_kf->next->auto_index = 0;
     last_auto_kf->auto_index = last_auto_kf->prev->auto_index + 1;
+    last_auto_kf->serial = ++auto_kf_serial;
 
     current_key_frame = &last_auto_kf->kf;
 
@@ -392,7 +568,13 @@ void dsda_UpdateAutoKeyFrames(void) {
       unsigned long long elapsed_time;
 
       dsda_StartTimer(dsda_timer_key_frame);
+      dsda_FinishAutoKeyFrame();
       dsda_StoreKeyFrame(current_key_frame, false, false);
+
+      if (!first_kf.buffer)
+        dsda_CopyKeyFrame(&first_kf, current_key_frame);
+
+      dsda_EncodeAutoKeyFrame(last_auto_kf);
       elapsed_time = dsda_ElapsedTimeMS(dsda_timer_key_frame);
 
       if (autoKeyFrameTimeout()) {
@@ -408,8 +590,5 @@ void dsda_UpdateAutoKeyFrames(void) {
           auto_kf_timeout_count = 0;
       }
     }
-
-    if (!first_kf.buffer)
-      dsda_CopyKeyFrame(&first_kf, current_key_frame);
   }
 }
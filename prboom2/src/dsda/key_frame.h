@@ -23,19 +23,26 @@
 struct auto_kf_s;
 
 typedef struct {
-  byte* buffer;
+  int serial;
   struct auto_kf_s* auto_kf;
 } parent_kf_t;
 
 typedef struct {
   byte* buffer;
   int buffer_length;
+  int archive_offset;
   int game_tic_count;
   parent_kf_t parent;
 } dsda_key_frame_t;
 
+// Auto key frames hold their state delta encoded against the previous one,
+// with a full frame every dsda_auto_key_frame_full_interval entries
 typedef struct auto_kf_s {
   int auto_index;
+  int serial;
+  int ref_serial;
+  int chain;
+  int length;
   dsda_key_frame_t kf;
   struct auto_kf_s* prev;
   struct auto_kf_s* next;
@@ -43,8 +50,11 @@ typedef struct auto_kf_s {
 
 void dsda_StoreKeyFrame(dsda_key_frame_t* key_frame, byte complete, byte export);
 void dsda_RestoreKeyFrame(dsda_key_frame_t* key_frame, dboolean skip_wipe);
+void dsda_WriteKeyFrame(dsda_key_frame_t* key_frame, const char* name);
+void dsda_RestoreKeyFrameFile(const char* name, dboolean skip_wipe);
 void dsda_InitKeyFrame(void);
 void dsda_ContinueKeyFrame(void);
+void dsda_ContinuePlaybackKeyFrame(void);
 int dsda_KeyFrameRestored(void);
 void dsda_StoreTempKeyFrame(void);
 void dsda_StoreQuickKeyFrame(void);
@@ -0,0 +1,310 @@
+//
+// Copyright(C) 2026 by borogk
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//	DSDA Key Frame Delta
+//
+//  Key frames are XORed against a reference frame (the previous one, or
+//  nothing for a full frame) and the result is stored as runs:
+//    <zero run length> <literal length> <literal bytes>
+//  with lengths as base 128 varints. Consecutive key frames differ in
+//  few places, so most of a delta collapses into zero runs.
+//
+//  Encoding runs on a worker thread, one job at a time. The worker never
+//  allocates: the caller provides an output buffer of dsda_DeltaBound size.
+//  The thread is joined at exit, and a forked child falls back to
+//  encoding synchronously since the thread isn't copied into it.
+//
+
+#include <string.h>
+
+#include "SDL.h"
+#include "SDL_thread.h"
+
+#include "i_system.h"
+#include "lprintf.h"
+
+#include "key_frame_delta.h"
+
+// Zero runs shorter than this are cheaper to keep in the literal
+#define MIN_ZERO_RUN 8
+
+int dsda_DeltaBound(int length) {
+  // Every run header replaces at least MIN_ZERO_RUN zero bytes,
+  // except for the first and the last one
+  return length + length / 4 + 64;
+}
+
+static byte dsda_DeltaByte(const byte* data, const byte* ref, int ref_length, int i) {
+  return i < ref_length ? data[i] ^ ref[i] : data[i];
+}
+
+static byte* dsda_WriteVarint(byte* p, unsigned int value) {
+  while (value >= 0x80) {
+    *p++ = (byte) (value | 0x80);
+    value >>= 7;
+  }
+
+  *p++ = (byte) value;
+
+  return p;
+}
+
+static const byte* dsda_ReadVarint(const byte* p, const byte* end, unsigned int* value) {
+  int shift = 0;
+
+  *value = 0;
+
+  while (p < end) {
+    byte b = *p++;
+
+    *value |= (unsigned int) (b & 0x7f) << shift;
+
+    if (!(b & 0x80))
+      return p;
+
+    shift += 7;
+  }
+
+  I_Error("dsda_ReadVarint: corrupt key frame delta");
+
+  return p;
+}
+
+int dsda_EncodeDelta(byte* out, const byte* data, int length, const byte* ref, int ref_length) {
+  byte* p = out;
+  int i = 0;
+
+  if (!ref)
+    ref_length = 0;
+
+  while (i < length) {
+    int zero_start = i;
+    int literal_start;
+    int j;
+
+    while (i < length && !dsda_DeltaByte(data, ref, ref_length, i))
+      ++i;
+
+    literal_start = i;
+
+    // The literal ends at the first long enough zero run
+    while (i < length) {
+      if (!dsda_DeltaByte(data, ref, ref_length, i)) {
+        for (j = i; j < length && j - i < MIN_ZERO_RUN; ++j)
+          if (dsda_DeltaByte(data, ref, ref_length, j))
+            break;
+
+        if (j - i == MIN_ZERO_RUN || j == length)
+          break;
+
+        i = j;
+      }
+      else
+        ++i;
+    }
+
+    p = dsda_WriteVarint(p, literal_start - zero_start);
+    p = dsda_WriteVarint(p, i - literal_start);
+
+    for (j = literal_start; j < i; ++j)
+      *p++ = dsda_DeltaByte(data, ref, ref_length, j);
+  }
+
+  return p - out;
+}
+
+void dsda_DecodeDelta(byte* out, int length, const byte* in, int in_length, const byte* ref, int ref_length) {
+  const byte* p = in;
+  const byte* end = in + in_length;
+  int i = 0;
+
+  if (!ref)
+    ref_length = 0;
+
+  while (p < end) {
+    unsigned int zero_run, literal_run;
+
+    p = dsda_ReadVarint(p, end, &zero_run);
+    p = dsda_ReadVarint(p, end, &literal_run);
+
+    if (zero_run > (unsigned int) (length - i) ||
+        literal_run > (unsigned int) (length - i - zero_run) ||
+        literal_run > (unsigned int) (end - p))
+      I_Error("dsda_DecodeDelta: corrupt key frame delta");
+
+    memset(out + i, 0, zero_run);
+    i += zero_run;
+
+    memcpy(out + i, p, literal_run);
+    p += literal_run;
+    i += literal_run;
+  }
+
+  if (i != length)
+    I_Error("dsda_DecodeDelta: corrupt key frame delta");
+
+  for (i = 0; i < length && i < ref_length; ++i)
+    out[i] ^= ref[i];
+}
+
+typedef struct {
+  byte* out;
+  const byte* data;
+  int length;
+  const byte* ref;
+  int ref_length;
+  int result;
+} delta_job_t;
+
+static delta_job_t delta_job;
+static dboolean delta_job_pending;
+static dboolean delta_job_done;
+
+static SDL_mutex* delta_mutex;
+static SDL_cond* delta_cond;
+static SDL_Thread* delta_thread;
+static dboolean delta_thread_failed;
+static dboolean delta_thread_quit;
+
+static int dsda_DeltaThread(void* unused) {
+  SDL_LockMutex(delta_mutex);
+
+  while (1) {
+    while ((!delta_job_pending || delta_job_done) && !delta_thread_quit)
+      SDL_CondWait(delta_cond, delta_mutex);
+
+    if (delta_thread_quit)
+      break;
+
+    SDL_UnlockMutex(delta_mutex);
+
+    delta_job.result = dsda_EncodeDelta(delta_job.out, delta_job.data, delta_job.length,
+                                        delta_job.ref, delta_job.ref_length);
+
+    SDL_LockMutex(delta_mutex);
+    delta_job_done = true;
+    SDL_CondBroadcast(delta_cond);
+  }
+
+  SDL_UnlockMutex(delta_mutex);
+
+  return 0;
+}
+
+// Later jobs are encoded by the caller
+static void dsda_DetachDeltaThread(dboolean redo_job) {
+  delta_thread = NULL;
+  delta_thread_failed = true;
+
+  if (delta_job_pending && (redo_job || !delta_job_done)) {
+    delta_job.result = dsda_EncodeDelta(delta_job.out, delta_job.data, delta_job.length,
+                                        delta_job.ref, delta_job.ref_length);
+    delta_job_done = true;
+  }
+}
+
+static void dsda_StopDeltaThread(void) {
+  int s;
+
+  if (!delta_thread)
+    return;
+
+  SDL_LockMutex(delta_mutex);
+  delta_thread_quit = true;
+  SDL_CondBroadcast(delta_cond);
+  SDL_UnlockMutex(delta_mutex);
+
+  SDL_WaitThread(delta_thread, &s);
+
+  dsda_DetachDeltaThread(false);
+}
+
+// The child of a fork() has the thread's state but not the thread.
+// Its mutex may have been copied locked, so it is left alone, and
+// a job that was in flight is encoded again here.
+void dsda_ResetDeltaThreadAfterFork(void) {
+  if (!delta_thread)
+    return;
+
+  delta_mutex = NULL;
+  delta_cond = NULL;
+
+  dsda_DetachDeltaThread(true);
+}
+
+static dboolean dsda_StartDeltaThread(void) {
+  if (delta_thread)
+    return true;
+
+  if (delta_thread_failed)
+    return false;
+
+  delta_mutex = SDL_CreateMutex();
+  delta_cond = SDL_CreateCond();
+  if (delta_mutex && delta_cond)
+    delta_thread = SDL_CreateThread(dsda_DeltaThread, "dsda_DeltaThread", NULL);
+
+  if (delta_thread)
+    I_AtExit(dsda_StopDeltaThread, true, "dsda_StopDeltaThread", exit_priority_first);
+
+  if (!delta_thread) {
+    delta_thread_failed = true;
+    lprintf(LO_WARN, "dsda_StartDeltaThread: key frames will be encoded synchronously\n");
+  }
+
+  return delta_thread != NULL;
+}
+
+// The buffers must stay untouched until dsda_FinishDeltaJob
+void dsda_StartDeltaJob(byte* out, const byte* data, int length, const byte* ref, int ref_length) {
+  dsda_FinishDeltaJob();
+
+  delta_job.out = out;
+  delta_job.data = data;
+  delta_job.length = length;
+  delta_job.ref = ref;
+  delta_job.ref_length = ref_length;
+  delta_job.result = 0;
+
+  if (!dsda_StartDeltaThread()) {
+    delta_job.result = dsda_EncodeDelta(out, data, length, ref, ref_length);
+    delta_job_pending = true;
+    delta_job_done = true;
+    return;
+  }
+
+  SDL_LockMutex(delta_mutex);
+  delta_job_pending = true;
+  delta_job_done = false;
+  SDL_CondBroadcast(delta_cond);
+  SDL_UnlockMutex(delta_mutex);
+}
+
+// Waits for the pending job, returns its encoded length or 0 if there was none
+int dsda_FinishDeltaJob(void) {
+  if (!delta_job_pending)
+    return 0;
+
+  if (delta_thread) {
+    SDL_LockMutex(delta_mutex);
+    while (!delta_job_done)
+      SDL_CondWait(delta_cond, delta_mutex);
+    delta_job_pending = false;
+    SDL_UnlockMutex(delta_mutex);
+  }
+  else
+    delta_job_pending = false;
+
+  return delta_job.result;
+}
@@ -0,0 +1,30 @@
+//
+// Copyright(C) 2026 by borogk
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//	DSDA Key Frame Delta
+//
+
+#ifndef __DSDA_KEY_FRAME_DELTA__
+#define __DSDA_KEY_FRAME_DELTA__
+
+#include "doomtype.h"
+
+int dsda_DeltaBound(int length);
+int dsda_EncodeDelta(byte* out, const byte* data, int length, const byte* ref, int ref_length);
+void dsda_DecodeDelta(byte* out, int length, const byte* in, int in_length, const byte* ref, int ref_length);
+void dsda_StartDeltaJob(byte* out, const byte* data, int length, const byte* ref, int ref_length);
+int dsda_FinishDeltaJob(void);
+void dsda_ResetDeltaThreadAfterFork(void);
+
+#endif
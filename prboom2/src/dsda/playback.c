@@ -84,6 +84,10 @@ const char* dsda_PlaybackName(void) {
   return playback_name;
 }
 
+const char* dsda_PlaybackFileName(void) {
+  return playback_filename;
+}
+
 void dsda_ExecutePlaybackOptions(void) {
   if (playdemo_arg)
   {
@@ -172,14 +176,27 @@ int dsda_PlaybackTics(void) {
   return playback_tics;
 }
 
+// The position is stored as an offset into the stream,
+// so that key frames stay valid when loaded by another process
 void dsda_StorePlaybackPosition(void) {
+  int64_t playback_offset;
+
+  playback_offset = playback_p ? playback_p - playback_origin_p : -1;
+
   P_SAVE_X(playback_tics);
-  P_SAVE_X(playback_p);
+  P_SAVE_X(playback_offset);
 }
 
 void dsda_RestorePlaybackPosition(void) {
+  int64_t playback_offset;
+
   P_LOAD_X(playback_tics);
-  P_LOAD_X(playback_p);
+  P_LOAD_X(playback_offset);
+
+  if (playback_origin_p && playback_offset >= 0 && playback_offset <= playback_length)
+    playback_p = playback_origin_p + playback_offset;
+  else
+    playback_p = NULL;
 }
 
 void dsda_ClearPlaybackStream(void) {
@@ -26,6 +26,7 @@ dboolean dsda_JumpToLogicTicFrom(int tic, int from_tic);
 void dsda_ExecutePlaybackOptions(void);
 const char* dsda_ParsePlaybackOptions(void);
 const char* dsda_PlaybackName(void);
+const char* dsda_PlaybackFileName(void);
 void dsda_ClearPlaybackStream(void);
 void dsda_InitDemoPlayback(void);
 void dsda_AttachPlaybackStream(const byte* demo_p, int length, int behaviour);
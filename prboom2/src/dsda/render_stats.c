@@ -23,10 +23,12 @@
 static dsda_render_stats_t frame_stats;
 static dsda_render_stats_t interval_stats;
 static int frame_count;
+static int bsp_cache_hits;
 
 dsda_render_stats_t dsda_render_stats;
 dsda_render_stats_t dsda_render_stats_max;
 int dsda_render_stats_fps = 35;
+int dsda_render_stats_bsp_cache_rate;
 
 static void dsda_UpdateMaxValues(dsda_render_stats_t* x, dsda_render_stats_t* y) {
   if (x->visplanes < y->visplanes)
@@ -44,6 +46,7 @@ void dsda_BeginRenderStats(void) {
   ZERO_DATA(interval_stats);
   ZERO_DATA(dsda_render_stats);
   ZERO_DATA(dsda_render_stats_max);
+  bsp_cache_hits = 0;
 
   dsda_StartTimer(dsda_timer_render_stats);
 }
@@ -72,6 +75,10 @@ void dsda_RecordDrawSegs(int n) {
   frame_stats.drawsegs += n;
 }
 
+void dsda_RecordBSPCacheHit(void) {
+  ++bsp_cache_hits;
+}
+
 void dsda_UpdateRenderStats(void) {
   dsda_UpdateMaxValues(&interval_stats, &frame_stats);
 
@@ -83,7 +90,9 @@ void dsda_UpdateRenderStats(void) {
     ZERO_DATA(interval_stats);
     dsda_UpdateMaxValues(&dsda_render_stats_max, &dsda_render_stats);
     dsda_render_stats_fps = frame_count * 1000 / dsda_ElapsedTimeMS(dsda_timer_render_stats);
+    dsda_render_stats_bsp_cache_rate = bsp_cache_hits * 100 / frame_count;
     frame_count = 0;
+    bsp_cache_hits = 0;
     dsda_StartTimer(dsda_timer_render_stats);
   }
 }
@@ -31,6 +31,7 @@ void dsda_RecordVisPlane(void);
 void dsda_RecordVisPlanes(int n);
 void dsda_RecordDrawSeg(void);
 void dsda_RecordDrawSegs(int n);
+void dsda_RecordBSPCacheHit(void);
 void dsda_UpdateRenderStats(void);
 
 #endif
@@ -0,0 +1,433 @@
+//
+// Copyright(C) 2026 by borogk
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//	DSDA Seek Index
+//
+//  While a demo plays, a compressed key frame is stored every
+//  dsda_demo_seek_index_interval seconds and the collection is saved
+//  beside the demo as <demo>.kfi. The file is keyed by a checksum of the
+//  demo, the loaded lumps, the dehacked patches, the game mode and the
+//  port version, so a stale index is ignored.
+//  On later playbacks, skip mode jumps to the closest stored key frame
+//  instead of replaying everything before it.
+//
+
+#include <stdio.h>
+#include <string.h>
+#include <zlib.h>
+
+#include "d_deh.h"
+#include "d_event.h"
+#include "doomstat.h"
+#include "lprintf.h"
+#include "m_file.h"
+#include "md5.h"
+#include "i_system.h"
+#include "w_wad.h"
+#include "z_zone.h"
+
+#include "dsda/args.h"
+#include "dsda/configuration.h"
+#include "dsda/key_frame.h"
+#include "dsda/playback.h"
+#include "dsda/skip.h"
+#include "dsda/utility.h"
+
+#include "seek_index.h"
+
+#define SEEK_INDEX_MAGIC "DSDAKFI1"
+#define SEEK_INDEX_MAGIC_SIZE 8
+#define SEEK_INDEX_KEY_SIZE 16
+
+// Jumps shorter than this are cheaper to just play through
+#define SEEK_INDEX_MIN_JUMP TICRATE
+
+typedef struct {
+  int tic;
+  int length;
+  int compressed_length;
+  byte* data;
+} seek_entry_t;
+
+static seek_entry_t* seek_entries;
+static int seek_entry_count;
+static int seek_entry_size;
+
+static char* seek_index_name;
+static byte seek_index_key[SEEK_INDEX_KEY_SIZE];
+static int seek_index_interval;
+static dboolean seek_index_active;
+static dboolean seek_index_dirty;
+static dboolean seek_index_read_only;
+
+static void dsda_FreeSeekEntries(void) {
+  int i;
+
+  for (i = 0; i < seek_entry_count; ++i)
+    Z_Free(seek_entries[i].data);
+
+  Z_Free(seek_entries);
+  seek_entries = NULL;
+  seek_entry_count = 0;
+  seek_entry_size = 0;
+}
+
+// Index of the last entry at or before tic, or -1
+static int dsda_FindSeekEntry(int tic) {
+  int lo = 0;
+  int hi = seek_entry_count;
+
+  while (lo < hi) {
+    int mid = (lo + hi) / 2;
+
+    if (seek_entries[mid].tic <= tic)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+
+  return lo - 1;
+}
+
+// Entries stay sorted by tic
+static seek_entry_t* dsda_InsertSeekEntry(int tic) {
+  int i;
+
+  i = dsda_FindSeekEntry(tic) + 1;
+
+  if (seek_entry_count == seek_entry_size) {
+    seek_entry_size = seek_entry_size ? seek_entry_size * 2 : 64;
+    seek_entries = Z_Realloc(seek_entries, seek_entry_size * sizeof(*seek_entries));
+  }
+
+  memmove(&seek_entries[i + 1], &seek_entries[i], (seek_entry_count - i) * sizeof(*seek_entries));
+  ++seek_entry_count;
+
+  memset(&seek_entries[i], 0, sizeof(*seek_entries));
+  seek_entries[i].tic = tic;
+
+  return &seek_entries[i];
+}
+
+// The lumps don't change once loaded, so they are only read once
+static const byte* dsda_LumpChecksum(void) {
+  static byte checksum[16];
+  static dboolean computed;
+  struct MD5Context md5;
+  byte* buffer = NULL;
+  int buffer_size = 0;
+  int i;
+
+  if (computed)
+    return checksum;
+
+  MD5Init(&md5);
+
+  for (i = 0; i < numlumps; ++i) {
+    const lumpinfo_t* lump = &lumpinfo[i];
+
+    MD5Update(&md5, (const byte*) lump->name, strlen(lump->name) + 1);
+    MD5Update(&md5, (const byte*) &lump->size, sizeof(lump->size));
+    MD5Update(&md5, (const byte*) &lump->li_namespace, sizeof(lump->li_namespace));
+
+    if (lump->size <= 0)
+      continue;
+
+    if (lump->size > buffer_size) {
+      buffer_size = lump->size;
+      buffer = Z_Realloc(buffer, buffer_size);
+    }
+
+    W_ReadLump(i, buffer);
+    MD5Update(&md5, buffer, lump->size);
+  }
+
+  Z_Free(buffer);
+
+  MD5Final(checksum, &md5);
+  computed = true;
+
+  return checksum;
+}
+
+static void dsda_SeekIndexKey(const byte* demo, int length) {
+  struct MD5Context md5;
+  byte deh_checksum[16];
+  int game[5];
+
+  MD5Init(&md5);
+
+  MD5Update(&md5, demo, length);
+
+  // Key frames are only valid for the same wad contents, so an edited
+  // wad under the same name gets a fresh index
+  MD5Update(&md5, dsda_LumpChecksum(), 16);
+
+  // The same goes for -deh / -bex patches and the game they apply to
+  DehChecksum(deh_checksum);
+  MD5Update(&md5, deh_checksum, sizeof(deh_checksum));
+
+  game[0] = gamemode;
+  game[1] = gamemission;
+  game[2] = compatibility_level;
+  game[3] = heretic;
+  game[4] = hexen;
+  MD5Update(&md5, (const byte*) game, sizeof(game));
+
+  // ...and the save format
+  MD5Update(&md5, (const byte*) PACKAGE_VERSION, strlen(PACKAGE_VERSION));
+
+  MD5Final(seek_index_key, &md5);
+}
+
+static int dsda_ReadSeekInt(const byte** p, const byte* end, int* value) {
+  if (end - *p < (int) sizeof(*value))
+    return false;
+
+  memcpy(value, *p, sizeof(*value));
+  *p += sizeof(*value);
+
+  return true;
+}
+
+static void dsda_LoadSeekIndex(void) {
+  byte* buffer;
+  const byte* p;
+  const byte* end;
+  int length;
+  int count;
+  int i;
+
+  if (!M_FileExists(seek_index_name))
+    return;
+
+  length = M_ReadFile(seek_index_name, &buffer);
+  if (length < 0)
+    return;
+
+  p = buffer;
+  end = buffer + length;
+
+  if (
+    length < SEEK_INDEX_MAGIC_SIZE + SEEK_INDEX_KEY_SIZE ||
+    memcmp(p, SEEK_INDEX_MAGIC, SEEK_INDEX_MAGIC_SIZE) ||
+    memcmp(p + SEEK_INDEX_MAGIC_SIZE, seek_index_key, SEEK_INDEX_KEY_SIZE)
+  ) {
+    lprintf(LO_INFO, "dsda_LoadSeekIndex: %s does not match this demo, rebuilding\n", seek_index_name);
+    Z_Free(buffer);
+    return;
+  }
+
+  p += SEEK_INDEX_MAGIC_SIZE + SEEK_INDEX_KEY_SIZE;
+
+  if (dsda_ReadSeekInt(&p, end, &count))
+    for (i = 0; i < count; ++i) {
+      seek_entry_t* entry;
+      int tic, entry_length, compressed_length;
+
+      if (
+        !dsda_ReadSeekInt(&p, end, &tic) ||
+        !dsda_ReadSeekInt(&p, end, &entry_length) ||
+        !dsda_ReadSeekInt(&p, end, &compressed_length) ||
+        entry_length <= 0 || compressed_length <= 0 ||
+        end - p < compressed_length
+      ) {
+        lprintf(LO_WARN, "dsda_LoadSeekIndex: %s is truncated\n", seek_index_name);
+        break;
+      }
+
+      entry = dsda_InsertSeekEntry(tic);
+      entry->length = entry_length;
+      entry->compressed_length = compressed_length;
+      entry->data = Z_Malloc(compressed_length);
+      memcpy(entry->data, p, compressed_length);
+
+      p += compressed_length;
+    }
+
+  Z_Free(buffer);
+
+  lprintf(LO_INFO, "dsda_LoadSeekIndex: %d key frames in %s\n", seek_entry_count, seek_index_name);
+}
+
+static void dsda_SaveSeekIndex(void) {
+  FILE* f;
+  int i;
+
+  if (!seek_index_dirty || seek_index_read_only)
+    return;
+
+  f = M_OpenFile(seek_index_name, "wb");
+  if (!f) {
+    lprintf(LO_WARN, "dsda_SaveSeekIndex: failed to write %s\n", seek_index_name);
+    return;
+  }
+
+  fwrite(SEEK_INDEX_MAGIC, 1, SEEK_INDEX_MAGIC_SIZE, f);
+  fwrite(seek_index_key, 1, SEEK_INDEX_KEY_SIZE, f);
+  fwrite(&seek_entry_count, sizeof(seek_entry_count), 1, f);
+
+  for (i = 0; i < seek_entry_count; ++i) {
+    seek_entry_t* entry = &seek_entries[i];
+
+    fwrite(&entry->tic, sizeof(entry->tic), 1, f);
+    fwrite(&entry->length, sizeof(entry->length), 1, f);
+    fwrite(&entry->compressed_length, sizeof(entry->compressed_length), 1, f);
+    fwrite(entry->data, 1, entry->compressed_length, f);
+  }
+
+  fclose(f);
+
+  seek_index_dirty = false;
+}
+
+void dsda_InitSeekIndex(const byte* demo, int length) {
+  static dboolean registered;
+  const char* filename;
+  const char* ext;
+
+  dsda_SaveSeekIndex();
+  dsda_FreeSeekEntries();
+
+  seek_index_active = false;
+  seek_index_interval = dsda_IntConfig(dsda_config_demo_seek_index_interval);
+  filename = dsda_PlaybackFileName();
+
+  if (!seek_index_interval || !filename || demorecording)
+    return;
+
+  // Segment processes of a split viddump share the index, leave it to the driver
+  seek_index_read_only = dsda_Arg(dsda_arg_viddump_segment)->found;
+
+  if (seek_index_name)
+    Z_Free(seek_index_name);
+
+  ext = strrchr(filename, '.');
+  if (!ext || strpbrk(ext, "/\\"))
+    ext = filename + strlen(filename);
+
+  seek_index_name = Z_Malloc(ext - filename + 5);
+  memcpy(seek_index_name, filename, ext - filename);
+  strcpy(seek_index_name + (ext - filename), ".kfi");
+
+  dsda_SeekIndexKey(demo, length);
+  dsda_LoadSeekIndex();
+
+  seek_index_active = true;
+
+  if (!registered) {
+    registered = true;
+    I_AtExit(dsda_SaveSeekIndex, false, "dsda_SaveSeekIndex", exit_priority_normal);
+  }
+}
+
+int dsda_SeekIndexClosestTic(int tic) {
+  int i;
+
+  if (!seek_index_active)
+    return -1;
+
+  i = dsda_FindSeekEntry(tic);
+
+  return i < 0 ? -1 : seek_entries[i].tic;
+}
+
+void dsda_RestoreSeekIndexKeyFrame(int tic) {
+  dsda_key_frame_t key_frame = { 0 };
+  seek_entry_t* entry;
+  uLongf length;
+  int i;
+
+  i = dsda_FindSeekEntry(tic);
+  if (i < 0 || seek_entries[i].tic != tic)
+    return;
+
+  entry = &seek_entries[i];
+  length = entry->length;
+  key_frame.buffer = Z_Malloc(length);
+  key_frame.buffer_length = entry->length;
+
+  if (
+    uncompress(key_frame.buffer, &length, entry->data, entry->compressed_length) != Z_OK ||
+    length != entry->length
+  )
+    I_Error("dsda_RestoreSeekIndexKeyFrame: corrupt key frame at tic %d in %s", tic, seek_index_name);
+
+  dsda_RestoreKeyFrame(&key_frame, true);
+
+  Z_Free(key_frame.buffer);
+}
+
+static void dsda_StoreSeekIndexKeyFrame(void) {
+  dsda_key_frame_t key_frame = { 0 };
+  seek_entry_t* entry;
+  uLongf compressed_length;
+  byte* data;
+
+  dsda_StoreKeyFrame(&key_frame, false, false);
+
+  compressed_length = compressBound(key_frame.buffer_length);
+  data = Z_Malloc(compressed_length);
+
+  if (compress2(data, &compressed_length, key_frame.buffer, key_frame.buffer_length, Z_BEST_SPEED) != Z_OK) {
+    Z_Free(data);
+    Z_Free(key_frame.buffer);
+    return;
+  }
+
+  entry = dsda_InsertSeekEntry(key_frame.game_tic_count);
+  entry->length = key_frame.buffer_length;
+  entry->compressed_length = compressed_length;
+  entry->data = Z_Realloc(data, compressed_length);
+
+  Z_Free(key_frame.buffer);
+
+  seek_index_dirty = true;
+}
+
+void dsda_UpdateSeekIndex(void) {
+  int i;
+
+  if (!seek_index_active || !demoplayback || gamestate != GS_LEVEL || gameaction != ga_nothing)
+    return;
+
+  // Jump ahead of the demo while skipping
+  if (dsda_SkipMode()) {
+    int target;
+
+    target = dsda_SkipTargetLogicTic();
+
+    if (target > 0) {
+      int tic;
+
+      tic = dsda_SeekIndexClosestTic(target);
+
+      if (tic - true_logictic >= SEEK_INDEX_MIN_JUMP) {
+        dsda_RestoreSeekIndexKeyFrame(tic);
+        dsda_SkipToLogicTicInPlace(target);
+
+        return;
+      }
+    }
+  }
+
+  if (!true_logictic || true_logictic % (seek_index_interval * TICRATE))
+    return;
+
+  i = dsda_FindSeekEntry(true_logictic);
+  if (i >= 0 && seek_entries[i].tic == true_logictic)
+    return;
+
+  dsda_StoreSeekIndexKeyFrame();
+}
@@ -128,6 +128,25 @@ void dsda_SkipToLogicTic(int tic) {
   dsda_EnterSkipMode();
 }
 
+// Retarget the current skip without restarting it, e.g. after jumping ahead
+void dsda_SkipToLogicTicInPlace(int tic) {
+  skip_until_logictic = tic;
+}
+
+// Logic tic the current skip ends at, or 0 if it isn't known in advance
+int dsda_SkipTargetLogicTic(void) {
+  if (!dsda_SkipMode())
+    return 0;
+
+  if (skip_until_logictic)
+    return skip_until_logictic;
+
+  if (skip_until_map == -1 && demo_skiptics > 0)
+    return true_logictic + demo_skiptics + 1 - gametic;
+
+  return 0;
+}
+
 void dsda_EvaluateSkipModeGTicker(void) {
   if (dsda_SkipMode() && skip_until_logictic && skip_until_logictic <= true_logictic)
     dsda_ExitSkipMode();
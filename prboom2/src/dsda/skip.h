@@ -24,6 +24,8 @@ void dsda_ToggleSkipMode(void);
 void dsda_SkipToNextMap(void);
 void dsda_SkipToEndOfMap(void);
 void dsda_SkipToLogicTic(int tic);
+void dsda_SkipToLogicTicInPlace(int tic);
+int dsda_SkipTargetLogicTic(void);
 void dsda_EvaluateSkipModeGTicker(void);
 void dsda_EvaluateSkipModeInitNew(void);
 void dsda_EvaluateSkipModeBuildTiccmd(void);
@@ -0,0 +1,595 @@
+//
+// Copyright(C) 2026 by borogk
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//	DSDA Sync Hash
+//
+//  With -synchash, every level tic appends a small record of hashes
+//  over parts of the game state to a file. Two files from runs of the
+//  same demo can be compared with -synchash_compare, which reports the
+//  first tic where the runs went apart and which parts differed.
+//
+//  dsda_PackGameState packs a fuller set of fields with the same words,
+//  for telling whether two game states will play on the same way.
+//
+
+#include <stdio.h>
+#include <string.h>
+
+#include "doomstat.h"
+#include "i_main.h"
+#include "lprintf.h"
+#include "m_file.h"
+#include "m_random.h"
+#include "i_system.h"
+#include "p_mobj.h"
+#include "p_spec.h"
+#include "p_tick.h"
+#include "r_state.h"
+#include "z_zone.h"
+
+#include "dsda/args.h"
+
+#include "sync_hash.h"
+
+#define SYNC_HASH_MAGIC "DSDASYN1"
+#define SYNC_HASH_MAGIC_SIZE 8
+
+typedef enum {
+  sync_hash_mobj_position,
+  sync_hash_mobj_momentum,
+  sync_hash_mobj_health,
+  sync_hash_sector_height,
+  sync_hash_rng,
+  sync_hash_thinker_count,
+  sync_hash_component_count
+} sync_hash_component_t;
+
+static const char* sync_hash_component_names[sync_hash_component_count] = {
+  [sync_hash_mobj_position] = "mobj positions",
+  [sync_hash_mobj_momentum] = "mobj momenta",
+  [sync_hash_mobj_health] = "mobj health",
+  [sync_hash_sector_height] = "sector heights",
+  [sync_hash_rng] = "rng",
+  [sync_hash_thinker_count] = "thinker count",
+};
+
+typedef struct {
+  int tic;
+  unsigned int component[sync_hash_component_count];
+} sync_hash_record_t;
+
+typedef struct {
+  unsigned int* words;
+  int count;
+  int size;
+} sync_hash_buffer_t;
+
+static FILE* sync_hash_file;
+static dboolean sync_hash_checked;
+static int sync_hash_last_tic = -1;
+
+static sync_hash_buffer_t mobj_position;
+static sync_hash_buffer_t mobj_momentum;
+static sync_hash_buffer_t mobj_health;
+static sync_hash_buffer_t sector_height;
+static sync_hash_buffer_t game_state;
+
+static void dsda_ResetSyncHashBuffer(sync_hash_buffer_t* buffer, int size) {
+  if (buffer->size < size) {
+    buffer->size = size;
+    buffer->words = Z_Realloc(buffer->words, size * sizeof(*buffer->words));
+  }
+
+  buffer->count = 0;
+}
+
+static void dsda_PushSyncHashWord(sync_hash_buffer_t* buffer, unsigned int word) {
+  if (buffer->count == buffer->size) {
+    buffer->size = buffer->size ? buffer->size * 2 : 1024;
+    buffer->words = Z_Realloc(buffer->words, buffer->size * sizeof(*buffer->words));
+  }
+
+  buffer->words[buffer->count++] = word;
+}
+
+#define SYNC_HASH_PRIME1 0x9e3779b1u
+#define SYNC_HASH_PRIME2 0x85ebca77u
+#define SYNC_HASH_PRIME3 0xc2b2ae3du
+
+#define SYNC_HASH_ROTL(x, r) (((x) << (r)) | ((x) >> (32 - (r))))
+
+// Four independent lanes over the packed words, so the main loop
+// compiles to vector multiplies
+static unsigned int dsda_SyncHashWords(const unsigned int* words, int count) {
+  unsigned int lane[4] = {
+    SYNC_HASH_PRIME1 + SYNC_HASH_PRIME2,
+    SYNC_HASH_PRIME2,
+    0,
+    0u - SYNC_HASH_PRIME1
+  };
+  unsigned int hash;
+  int i, j;
+
+  for (i = 0; i + 4 <= count; i += 4)
+    for (j = 0; j < 4; ++j) {
+      lane[j] += words[i + j] * SYNC_HASH_PRIME2;
+      lane[j] = SYNC_HASH_ROTL(lane[j], 13) * SYNC_HASH_PRIME1;
+    }
+
+  hash = SYNC_HASH_ROTL(lane[0], 1) + SYNC_HASH_ROTL(lane[1], 7) +
+         SYNC_HASH_ROTL(lane[2], 12) + SYNC_HASH_ROTL(lane[3], 18);
+  hash += (unsigned int) count;
+
+  for (; i < count; ++i) {
+    hash += words[i] * SYNC_HASH_PRIME3;
+    hash = SYNC_HASH_ROTL(hash, 17) * SYNC_HASH_PRIME1;
+  }
+
+  hash ^= hash >> 15;
+  hash *= SYNC_HASH_PRIME2;
+  hash ^= hash >> 13;
+  hash *= SYNC_HASH_PRIME3;
+  hash ^= hash >> 16;
+
+  return hash;
+}
+
+static dboolean dsda_IsMobj(const thinker_t* th) {
+  return th->function == P_MobjThinker || th->function == P_BlasterMobjThinker;
+}
+
+// Mobjs are referred to by their place in the thinker list, since
+// their addresses depend on allocation order. Removed mobjs that are
+// still referenced all pack the same.
+static unsigned int dsda_MobjWord(const mobj_t* mo) {
+  if (!mo)
+    return 0;
+
+  if (!dsda_IsMobj(&mo->thinker))
+    return 1;
+
+  return mo->archiveNum + 2;
+}
+
+static unsigned int dsda_StateWord(const state_t* state) {
+  return state ? state - states : -1;
+}
+
+static void dsda_PackPlayer(sync_hash_buffer_t* b, const player_t* player) {
+  int i;
+
+  // cmd is left out: it's replaced before it's read again
+  dsda_PushSyncHashWord(b, dsda_MobjWord(player->mo));
+  dsda_PushSyncHashWord(b, player->playerstate);
+  dsda_PushSyncHashWord(b, player->viewz);
+  dsda_PushSyncHashWord(b, player->viewheight);
+  dsda_PushSyncHashWord(b, player->deltaviewheight);
+  dsda_PushSyncHashWord(b, player->bob);
+  dsda_PushSyncHashWord(b, player->health);
+  for (i = 0; i < NUMARMOR; ++i)
+    dsda_PushSyncHashWord(b, player->armorpoints[i]);
+  dsda_PushSyncHashWord(b, player->armortype);
+  for (i = 0; i < NUMPOWERS; ++i)
+    dsda_PushSyncHashWord(b, player->powers[i]);
+  for (i = 0; i < NUMCARDS; ++i)
+    dsda_PushSyncHashWord(b, player->cards[i]);
+  dsda_PushSyncHashWord(b, player->backpack);
+  dsda_PushSyncHashWord(b, player->readyweapon);
+  dsda_PushSyncHashWord(b, player->pendingweapon);
+  for (i = 0; i < NUMWEAPONS; ++i)
+    dsda_PushSyncHashWord(b, player->weaponowned[i]);
+  for (i = 0; i < NUMAMMO; ++i) {
+    dsda_PushSyncHashWord(b, player->ammo[i]);
+    dsda_PushSyncHashWord(b, player->maxammo[i]);
+  }
+  dsda_PushSyncHashWord(b, player->attackdown);
+  dsda_PushSyncHashWord(b, player->usedown);
+  dsda_PushSyncHashWord(b, player->cheats);
+  dsda_PushSyncHashWord(b, player->refire);
+  dsda_PushSyncHashWord(b, player->killcount);
+  dsda_PushSyncHashWord(b, player->itemcount);
+  dsda_PushSyncHashWord(b, player->secretcount);
+  dsda_PushSyncHashWord(b, player->damagecount);
+  dsda_PushSyncHashWord(b, player->bonuscount);
+  dsda_PushSyncHashWord(b, dsda_MobjWord(player->attacker));
+  dsda_PushSyncHashWord(b, player->extralight);
+  dsda_PushSyncHashWord(b, player->fixedcolormap);
+  for (i = 0; i < NUMPSPRITES; ++i) {
+    dsda_PushSyncHashWord(b, dsda_StateWord(player->psprites[i].state));
+    dsda_PushSyncHashWord(b, player->psprites[i].tics);
+    dsda_PushSyncHashWord(b, player->psprites[i].sx);
+    dsda_PushSyncHashWord(b, player->psprites[i].sy);
+  }
+  dsda_PushSyncHashWord(b, player->momx);
+  dsda_PushSyncHashWord(b, player->momy);
+
+  // heretic and hexen
+  dsda_PushSyncHashWord(b, player->flyheight);
+  dsda_PushSyncHashWord(b, player->lookdir);
+  dsda_PushSyncHashWord(b, player->centering);
+  for (i = 0; i < player->inventorySlotNum && i < NUMINVENTORYSLOTS; ++i) {
+    dsda_PushSyncHashWord(b, player->inventory[i].type);
+    dsda_PushSyncHashWord(b, player->inventory[i].count);
+  }
+  dsda_PushSyncHashWord(b, player->readyArtifact);
+  dsda_PushSyncHashWord(b, player->artifactCount);
+  dsda_PushSyncHashWord(b, player->inventorySlotNum);
+  dsda_PushSyncHashWord(b, player->flamecount);
+  dsda_PushSyncHashWord(b, player->chickenTics);
+  dsda_PushSyncHashWord(b, player->chickenPeck);
+  dsda_PushSyncHashWord(b, dsda_MobjWord(player->rain1));
+  dsda_PushSyncHashWord(b, dsda_MobjWord(player->rain2));
+  dsda_PushSyncHashWord(b, player->pclass);
+  dsda_PushSyncHashWord(b, player->morphTics);
+  dsda_PushSyncHashWord(b, player->pieces);
+  dsda_PushSyncHashWord(b, player->poisoncount);
+  dsda_PushSyncHashWord(b, dsda_MobjWord(player->poisoner));
+  dsda_PushSyncHashWord(b, player->jumpTics);
+  dsda_PushSyncHashWord(b, player->hazardcount);
+  dsda_PushSyncHashWord(b, player->hazardinterval);
+}
+
+static void dsda_PackMobj(sync_hash_buffer_t* b, const mobj_t* mo) {
+  int i;
+
+  // The block and sector links follow from the position
+  dsda_PushSyncHashWord(b, mo->x);
+  dsda_PushSyncHashWord(b, mo->y);
+  dsda_PushSyncHashWord(b, mo->z);
+  dsda_PushSyncHashWord(b, mo->angle);
+  dsda_PushSyncHashWord(b, mo->pitch);
+  dsda_PushSyncHashWord(b, mo->sprite);
+  dsda_PushSyncHashWord(b, mo->frame);
+  dsda_PushSyncHashWord(b, mo->floorz);
+  dsda_PushSyncHashWord(b, mo->ceilingz);
+  dsda_PushSyncHashWord(b, mo->dropoffz);
+  dsda_PushSyncHashWord(b, mo->radius);
+  dsda_PushSyncHashWord(b, mo->height);
+  dsda_PushSyncHashWord(b, mo->momx);
+  dsda_PushSyncHashWord(b, mo->momy);
+  dsda_PushSyncHashWord(b, mo->momz);
+  dsda_PushSyncHashWord(b, mo->type);
+  dsda_PushSyncHashWord(b, mo->tics);
+  dsda_PushSyncHashWord(b, dsda_StateWord(mo->state));
+  dsda_PushSyncHashWord(b, (unsigned int) mo->flags);
+  dsda_PushSyncHashWord(b, (unsigned int) (mo->flags >> 32));
+  dsda_PushSyncHashWord(b, (unsigned int) mo->flags2);
+  dsda_PushSyncHashWord(b, (unsigned int) (mo->flags2 >> 32));
+  dsda_PushSyncHashWord(b, mo->intflags);
+  dsda_PushSyncHashWord(b, mo->health);
+  dsda_PushSyncHashWord(b, mo->movedir);
+  dsda_PushSyncHashWord(b, mo->movecount);
+  dsda_PushSyncHashWord(b, mo->strafecount);
+  dsda_PushSyncHashWord(b, dsda_MobjWord(mo->target));
+  dsda_PushSyncHashWord(b, mo->reactiontime);
+  dsda_PushSyncHashWord(b, mo->threshold);
+  dsda_PushSyncHashWord(b, mo->pursuecount);
+  dsda_PushSyncHashWord(b, mo->gear);
+  dsda_PushSyncHashWord(b, mo->player ? mo->player - players + 1 : 0);
+  dsda_PushSyncHashWord(b, mo->lastlook);
+  dsda_PushSyncHashWord(b, mo->spawnpoint.x);
+  dsda_PushSyncHashWord(b, mo->spawnpoint.y);
+  dsda_PushSyncHashWord(b, mo->spawnpoint.angle);
+  dsda_PushSyncHashWord(b, mo->spawnpoint.type);
+  dsda_PushSyncHashWord(b, mo->spawnpoint.options);
+  dsda_PushSyncHashWord(b, dsda_MobjWord(mo->tracer));
+  dsda_PushSyncHashWord(b, dsda_MobjWord(mo->lastenemy));
+  dsda_PushSyncHashWord(b, mo->friction);
+  dsda_PushSyncHashWord(b, mo->movefactor);
+  dsda_PushSyncHashWord(b, mo->damage);
+  dsda_PushSyncHashWord(b, mo->special1.i);
+  dsda_PushSyncHashWord(b, dsda_MobjWord(mo->special1.m));
+  dsda_PushSyncHashWord(b, mo->special2.i);
+  dsda_PushSyncHashWord(b, dsda_MobjWord(mo->special2.m));
+  dsda_PushSyncHashWord(b, mo->floorclip);
+  dsda_PushSyncHashWord(b, mo->tid);
+  dsda_PushSyncHashWord(b, mo->special);
+  for (i = 0; i < 5; ++i)
+    dsda_PushSyncHashWord(b, mo->special_args[i]);
+  dsda_PushSyncHashWord(b, mo->gravity);
+}
+
+// Floor and ceiling movers, by sector so their order doesn't matter
+static void dsda_PackMover(sync_hash_buffer_t* b, const thinker_t* th) {
+  if (th->function == T_MoveFloor) {
+    const floormove_t* floor = (const floormove_t*) th;
+
+    dsda_PushSyncHashWord(b, floor->sector->iSectorID);
+    dsda_PushSyncHashWord(b, floor->type);
+    dsda_PushSyncHashWord(b, floor->direction);
+    dsda_PushSyncHashWord(b, floor->floordestheight);
+    dsda_PushSyncHashWord(b, floor->speed);
+    dsda_PushSyncHashWord(b, floor->delayCount);
+    dsda_PushSyncHashWord(b, floor->resetDelayCount);
+  }
+  else if (th->function == T_MoveCeiling) {
+    const ceiling_t* ceiling = (const ceiling_t*) th;
+
+    dsda_PushSyncHashWord(b, ceiling->sector->iSectorID);
+    dsda_PushSyncHashWord(b, ceiling->type);
+    dsda_PushSyncHashWord(b, ceiling->direction);
+    dsda_PushSyncHashWord(b, ceiling->olddirection);
+    dsda_PushSyncHashWord(b, ceiling->bottomheight);
+    dsda_PushSyncHashWord(b, ceiling->topheight);
+    dsda_PushSyncHashWord(b, ceiling->speed);
+  }
+  else if (th->function == T_VerticalDoor) {
+    const vldoor_t* door = (const vldoor_t*) th;
+
+    dsda_PushSyncHashWord(b, door->sector->iSectorID);
+    dsda_PushSyncHashWord(b, door->type);
+    dsda_PushSyncHashWord(b, door->direction);
+    dsda_PushSyncHashWord(b, door->topheight);
+    dsda_PushSyncHashWord(b, door->speed);
+    dsda_PushSyncHashWord(b, door->topcountdown);
+  }
+  else if (th->function == T_PlatRaise) {
+    const plat_t* plat = (const plat_t*) th;
+
+    dsda_PushSyncHashWord(b, plat->sector->iSectorID);
+    dsda_PushSyncHashWord(b, plat->type);
+    dsda_PushSyncHashWord(b, plat->status);
+    dsda_PushSyncHashWord(b, plat->oldstatus);
+    dsda_PushSyncHashWord(b, plat->low);
+    dsda_PushSyncHashWord(b, plat->high);
+    dsda_PushSyncHashWord(b, plat->speed);
+    dsda_PushSyncHashWord(b, plat->count);
+  }
+  else if (th->function == T_MoveElevator) {
+    const elevator_t* elevator = (const elevator_t*) th;
+
+    dsda_PushSyncHashWord(b, elevator->sector->iSectorID);
+    dsda_PushSyncHashWord(b, elevator->type);
+    dsda_PushSyncHashWord(b, elevator->direction);
+    dsda_PushSyncHashWord(b, elevator->floordestheight);
+    dsda_PushSyncHashWord(b, elevator->ceilingdestheight);
+    dsda_PushSyncHashWord(b, elevator->speed);
+  }
+}
+
+// Packs the players, mobjs, movers, sectors, lines and rng.
+// Ticcmds and pointers are left out, so states reached through
+// different commands or allocation orders pack the same.
+const unsigned int* dsda_PackGameState(int* count) {
+  sync_hash_buffer_t* b = &game_state;
+  thinker_t* th;
+  int thinker_count;
+  int mobj_count;
+  int i;
+
+  dsda_ResetSyncHashBuffer(b, 0);
+
+  thinker_count = 0;
+  mobj_count = 0;
+  for (th = thinkercap.next; th != &thinkercap; th = th->next) {
+    ++thinker_count;
+
+    if (dsda_IsMobj(th))
+      ((mobj_t*) th)->archiveNum = mobj_count++;
+  }
+
+  dsda_PushSyncHashWord(b, thinker_count);
+  dsda_PushSyncHashWord(b, mobj_count);
+
+  for (i = 0; i < MAX_MAXPLAYERS; ++i)
+    if (playeringame[i])
+      dsda_PackPlayer(b, &players[i]);
+
+  for (th = thinkercap.next; th != &thinkercap; th = th->next) {
+    if (dsda_IsMobj(th))
+      dsda_PackMobj(b, (mobj_t*) th);
+    else
+      dsda_PackMover(b, th);
+  }
+
+  for (i = 0; i < numsectors; ++i) {
+    const sector_t* sector = &sectors[i];
+
+    dsda_PushSyncHashWord(b, sector->floorheight);
+    dsda_PushSyncHashWord(b, sector->ceilingheight);
+    dsda_PushSyncHashWord(b, sector->lightlevel);
+    dsda_PushSyncHashWord(b, sector->special);
+    dsda_PushSyncHashWord(b, sector->flags);
+    dsda_PushSyncHashWord(b, sector->floorpic);
+    dsda_PushSyncHashWord(b, sector->ceilingpic);
+    dsda_PushSyncHashWord(b, dsda_MobjWord(sector->soundtarget));
+    dsda_PushSyncHashWord(b, (sector->floordata != NULL) |
+                             (sector->ceilingdata != NULL) << 1 |
+                             (sector->lightingdata != NULL) << 2);
+  }
+
+  for (i = 0; i < numlines; ++i) {
+    const line_t* line = &lines[i];
+
+    dsda_PushSyncHashWord(b, line->special);
+    dsda_PushSyncHashWord(b, line->player_activations);
+    dsda_PushSyncHashWord(b, line->specialdata != NULL);
+  }
+
+  for (i = 0; i < NUMPRCLASS; ++i)
+    dsda_PushSyncHashWord(b, rng.seed[i]);
+  dsda_PushSyncHashWord(b, rng.rndindex);
+  dsda_PushSyncHashWord(b, rng.prndindex);
+
+  *count = b->count;
+
+  return b->words;
+}
+
+static void dsda_CloseSyncHash(void) {
+  if (sync_hash_file) {
+    fclose(sync_hash_file);
+    sync_hash_file = NULL;
+  }
+}
+
+static void dsda_OpenSyncHash(void) {
+  dsda_arg_t* arg;
+  int count = sync_hash_component_count;
+
+  sync_hash_checked = true;
+
+  arg = dsda_Arg(dsda_arg_synchash);
+  if (!arg->found)
+    return;
+
+  sync_hash_file = M_OpenFile(arg->value.v_string, "wb");
+  if (!sync_hash_file)
+    I_Error("dsda_OpenSyncHash: failed to open %s", arg->value.v_string);
+
+  fwrite(SYNC_HASH_MAGIC, 1, SYNC_HASH_MAGIC_SIZE, sync_hash_file);
+  fwrite(&count, sizeof(count), 1, sync_hash_file);
+
+  I_AtExit(dsda_CloseSyncHash, true, "dsda_CloseSyncHash", exit_priority_normal);
+}
+
+void dsda_UpdateSyncHash(void) {
+  sync_hash_record_t record;
+  unsigned int rng_words[NUMPRCLASS + 2];
+  thinker_t* th;
+  int thinker_count;
+  int i;
+
+  if (!sync_hash_checked)
+    dsda_OpenSyncHash();
+
+  // Paused tics don't move the game, and a tic is only written once
+  if (!sync_hash_file || true_logictic == sync_hash_last_tic)
+    return;
+
+  sync_hash_last_tic = true_logictic;
+
+  dsda_ResetSyncHashBuffer(&mobj_position, 0);
+  dsda_ResetSyncHashBuffer(&mobj_momentum, 0);
+  dsda_ResetSyncHashBuffer(&mobj_health, 0);
+  dsda_ResetSyncHashBuffer(&sector_height, 2 * numsectors);
+
+  thinker_count = 0;
+  for (th = thinkercap.next; th != &thinkercap; th = th->next) {
+    ++thinker_count;
+
+    if (th->function == P_MobjThinker || th->function == P_BlasterMobjThinker) {
+      mobj_t* mo = (mobj_t*) th;
+
+      dsda_PushSyncHashWord(&mobj_position, mo->x);
+      dsda_PushSyncHashWord(&mobj_position, mo->y);
+      dsda_PushSyncHashWord(&mobj_position, mo->z);
+      dsda_PushSyncHashWord(&mobj_momentum, mo->momx);
+      dsda_PushSyncHashWord(&mobj_momentum, mo->momy);
+      dsda_PushSyncHashWord(&mobj_momentum, mo->momz);
+      dsda_PushSyncHashWord(&mobj_health, mo->health);
+    }
+  }
+
+  for (i = 0; i < numsectors; ++i) {
+    sector_height.words[2 * i] = sectors[i].floorheight;
+    sector_height.words[2 * i + 1] = sectors[i].ceilingheight;
+  }
+  sector_height.count = 2 * numsectors;
+
+  for (i = 0; i < NUMPRCLASS; ++i)
+    rng_words[i] = rng.seed[i];
+  rng_words[NUMPRCLASS] = rng.rndindex;
+  rng_words[NUMPRCLASS + 1] = rng.prndindex;
+
+  record.tic = true_logictic;
+  record.component[sync_hash_mobj_position] =
+    dsda_SyncHashWords(mobj_position.words, mobj_position.count);
+  record.component[sync_hash_mobj_momentum] =
+    dsda_SyncHashWords(mobj_momentum.words, mobj_momentum.count);
+  record.component[sync_hash_mobj_health] =
+    dsda_SyncHashWords(mobj_health.words, mobj_health.count);
+  record.component[sync_hash_sector_height] =
+    dsda_SyncHashWords(sector_height.words, sector_height.count);
+  record.component[sync_hash_rng] = dsda_SyncHashWords(rng_words, NUMPRCLASS + 2);
+  record.component[sync_hash_thinker_count] = thinker_count;
+
+  fwrite(&record, sizeof(record), 1, sync_hash_file);
+}
+
+static int dsda_LoadSyncHash(const char* name, sync_hash_record_t** records) {
+  byte* buffer;
+  int length;
+  int count;
+
+  length = M_ReadFile(name, &buffer);
+  if (length < 0)
+    I_Error("dsda_LoadSyncHash: failed to read %s", name);
+
+  if (
+    length < SYNC_HASH_MAGIC_SIZE + (int) sizeof(count) ||
+    memcmp(buffer, SYNC_HASH_MAGIC, SYNC_HASH_MAGIC_SIZE)
+  )
+    I_Error("dsda_LoadSyncHash: %s is not a sync hash file", name);
+
+  memcpy(&count, buffer + SYNC_HASH_MAGIC_SIZE, sizeof(count));
+  if (count != sync_hash_component_count)
+    I_Error("dsda_LoadSyncHash: %s was written by an incompatible version", name);
+
+  length -= SYNC_HASH_MAGIC_SIZE + sizeof(count);
+  count = length / sizeof(**records);
+
+  *records = Z_Malloc(count * sizeof(**records));
+  memcpy(*records, buffer + SYNC_HASH_MAGIC_SIZE + sizeof(count), count * sizeof(**records));
+
+  Z_Free(buffer);
+
+  return count;
+}
+
+void dsda_CompareSyncHashes(void) {
+  dsda_arg_t* arg;
+  sync_hash_record_t* a;
+  sync_hash_record_t* b;
+  int a_count, b_count;
+  int i, j;
+
+  arg = dsda_Arg(dsda_arg_synchash_compare);
+
+  a_count = dsda_LoadSyncHash(arg->value.v_string_array[0], &a);
+  b_count = dsda_LoadSyncHash(arg->value.v_string_array[1], &b);
+
+  for (i = 0; i < a_count && i < b_count; ++i)
+    if (memcmp(&a[i], &b[i], sizeof(a[i])))
+      break;
+
+  if (i < a_count && i < b_count) {
+    if (a[i].tic != b[i].tic) {
+      lprintf(LO_INFO, "Streams diverge after record %d: tic %d vs tic %d\n", i, a[i].tic, b[i].tic);
+    }
+    else {
+      lprintf(LO_INFO, "First divergent tic: %d\n", a[i].tic);
+
+      for (j = 0; j < sync_hash_component_count; ++j)
+        if (a[i].component[j] != b[i].component[j]) {
+          if (j == sync_hash_thinker_count)
+            lprintf(LO_INFO, "  %s: %u vs %u\n", sync_hash_component_names[j],
+                    a[i].component[j], b[i].component[j]);
+          else
+            lprintf(LO_INFO, "  %s\n", sync_hash_component_names[j]);
+        }
+    }
+
+    I_SafeExit(1);
+  }
+
+  if (a_count != b_count) {
+    lprintf(LO_INFO, "Streams match for %d tics, then %s ends\n",
+            i, arg->value.v_string_array[a_count < b_count ? 0 : 1]);
+    I_SafeExit(1);
+  }
+
+  lprintf(LO_INFO, "Streams match for all %d tics\n", i);
+  I_SafeExit(0);
+}
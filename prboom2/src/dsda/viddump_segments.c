@@ -0,0 +1,307 @@
+//
+// Copyright(C) 2026 by borogk
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//	DSDA Viddump Segments
+//
+//  With -viddump_segments, this process plays the demo without drawing,
+//  exports a key frame at each segment boundary and launches a child
+//  process per segment that captures it with -from_key_frame.
+//  Once every child is done, the segment files are joined into the
+//  -viddump file with cap_concatcommand.
+//
+
+#include <stdio.h>
+#include <string.h>
+
+#include "d_event.h"
+#include "d_main.h"
+#include "doomstat.h"
+#include "e6y.h"
+#include "i_capture.h"
+#include "i_main.h"
+#include "i_system.h"
+#include "lprintf.h"
+#include "m_file.h"
+#include "z_zone.h"
+
+#include "dsda/args.h"
+#include "dsda/configuration.h"
+#include "dsda/key_frame.h"
+#include "dsda/skip.h"
+#include "dsda/utility.h"
+
+#include "viddump_segments.h"
+
+static const char* segment_fn;
+static char* segment_base;
+static const char* segment_ext;
+
+static int segment_count;
+static int segment_length;
+static int segment_start = -1;
+static int segment_index;
+static int segment_end_tic;
+
+// segment boundaries line up with whole seconds so that
+// each segment starts on the same capture frame and sound cadence
+#define SEGMENT_ALIGNMENT TICRATE
+
+static char* dsda_SegmentFileName(int index, const char* ext) {
+  dsda_string_t name;
+
+  dsda_StringPrintF(&name, "%s-seg%02d%s", segment_base, index, ext);
+
+  return name.string;
+}
+
+static void dsda_QuoteArg(dsda_string_t* command, const char* arg) {
+#ifdef _WIN32
+  dsda_StringCatF(command, " \"%s\"", arg);
+#else
+  const char* p;
+
+  dsda_StringCat(command, " '");
+  for (p = arg; *p; ++p) {
+    if (*p == '\'')
+      dsda_StringCat(command, "'\\''");
+    else
+      dsda_StringCatF(command, "%c", *p);
+  }
+  dsda_StringCat(command, "'");
+#endif
+}
+
+// Arguments that the driver handles itself, or that don't apply to a segment
+static const char* dropped_args[] = {
+  "-viddump",
+  "-viddump_segments",
+  "-viddump_segment",
+  "-cman_viddump",
+  "-cman_auto_skip",
+  "-from_key_frame",
+  "-skipsec",
+  "-skiptic",
+  NULL
+};
+
+static dboolean dsda_DroppedArg(const char* arg) {
+  int i;
+
+  for (i = 0; dropped_args[i]; ++i)
+    if (!strcasecmp(arg, dropped_args[i]))
+      return true;
+
+  return false;
+}
+
+// Same rule as the argument parser: anything not starting with '-' is a
+// parameter, as is a negative integer
+static dboolean dsda_ArgParameter(const char* arg) {
+  int x;
+
+  return arg[0] != '-' || sscanf(arg, "%d", &x) == 1;
+}
+
+static void dsda_StartSegment(int index, int end_tic) {
+  extern int dsda_argc;
+  extern char** dsda_argv;
+
+  dsda_string_t command;
+  char* key_frame_name;
+  char* output_name;
+  char* dump_name;
+  int i;
+
+  key_frame_name = dsda_SegmentFileName(index, ".kf");
+  output_name = dsda_SegmentFileName(index, segment_ext);
+  dump_name = dsda_SegmentFileName(index, "");
+
+  dsda_InitString(&command, NULL);
+  dsda_QuoteArg(&command, dsda_argv[0]);
+
+  for (i = 1; i < dsda_argc; ++i) {
+    if (dsda_DroppedArg(dsda_argv[i])) {
+      while (i + 1 < dsda_argc && dsda_ArgParameter(dsda_argv[i + 1]))
+        ++i;
+
+      continue;
+    }
+
+    dsda_QuoteArg(&command, dsda_argv[i]);
+  }
+
+  if (dsda_Flag(dsda_arg_cman_viddump))
+    dsda_StringCat(&command, " -cman_auto_exit");
+
+  dsda_StringCat(&command, " -from_key_frame");
+  dsda_QuoteArg(&command, key_frame_name);
+  dsda_StringCat(&command, " -viddump");
+  dsda_QuoteArg(&command, output_name);
+  dsda_StringCatF(&command, " -viddump_segment %d %d", index, end_tic);
+
+  if (!I_CaptureStartProcess(command.string + 1, dump_name))
+    I_Error("dsda_StartSegment: failed to start segment %d", index);
+
+  dsda_FreeString(&command);
+  Z_Free(key_frame_name);
+  Z_Free(output_name);
+  Z_Free(dump_name);
+}
+
+static void dsda_FinishViddumpSegments(void) {
+  char* list_name;
+  FILE* list;
+  int i;
+
+  if (!segment_index)
+    return;
+
+  // The last segment runs until the end of the demo
+  dsda_StartSegment(segment_index - 1, 0);
+
+  lprintf(LO_INFO, "dsda_FinishViddumpSegments: waiting for %d segments\n", segment_index);
+
+  if (I_CaptureWaitProcesses())
+    I_Error("dsda_FinishViddumpSegments: segment rendering failed, not joining %s", segment_fn);
+
+  for (i = 0; i < segment_index; ++i) {
+    char* output_name;
+
+    output_name = dsda_SegmentFileName(i, segment_ext);
+    if (!M_FileExists(output_name))
+      I_Error("dsda_FinishViddumpSegments: segment %s is missing, not joining %s",
+              output_name, segment_fn);
+    Z_Free(output_name);
+  }
+
+  list_name = dsda_SegmentFileName(segment_index, ".txt");
+  list = M_OpenFile(list_name, "w");
+  if (!list)
+    I_Error("dsda_FinishViddumpSegments: failed to write %s", list_name);
+
+  for (i = 0; i < segment_index; ++i) {
+    char* output_name;
+
+    output_name = dsda_SegmentFileName(i, segment_ext);
+    fprintf(list, "file '%s'\n", output_name);
+    Z_Free(output_name);
+  }
+
+  fclose(list);
+
+  I_CaptureConcat(segment_fn, list_name);
+
+  if (dsda_IntConfig(dsda_config_cap_remove_tempfiles)) {
+    for (i = 0; i < segment_index; ++i) {
+      char* name;
+
+      name = dsda_SegmentFileName(i, ".kf");
+      M_remove(name);
+      Z_Free(name);
+
+      name = dsda_SegmentFileName(i, segment_ext);
+      M_remove(name);
+      Z_Free(name);
+    }
+
+    M_remove(list_name);
+  }
+
+  Z_Free(list_name);
+}
+
+void dsda_InitViddumpSegments(const char* fn) {
+  const char* ext;
+
+  segment_count = dsda_SimpleIntArg(dsda_arg_viddump_segments);
+  segment_fn = fn;
+
+  ext = strrchr(fn, '.');
+  if (!ext || strpbrk(ext, "/\\"))
+    ext = fn + strlen(fn);
+
+  segment_ext = ext;
+  segment_base = Z_Strdup(fn);
+  segment_base[ext - fn] = '\0';
+
+  I_AtExit(dsda_FinishViddumpSegments, false, "dsda_FinishViddumpSegments", exit_priority_normal);
+}
+
+static void dsda_UpdateSegmentDriver(void) {
+  dsda_key_frame_t key_frame = { 0 };
+  char* key_frame_name;
+
+  if (!demoplayback || dsda_SkipMode() || gamestate != GS_LEVEL || gameaction != ga_nothing)
+    return;
+
+  // Skip mode restores these on exit, so keep them applied here
+  fastdemo = true;
+  nodrawers = true;
+  nosfxparm = true;
+  nomusicparm = true;
+
+  if (segment_index >= segment_count)
+    return;
+
+  if (segment_start < 0) {
+    int tics;
+
+    segment_start = true_logictic;
+
+    tics = MAX(demo_tics_count - segment_start, 1);
+    segment_length = (tics + segment_count - 1) / segment_count;
+    segment_length = (segment_length + SEGMENT_ALIGNMENT - 1) / SEGMENT_ALIGNMENT * SEGMENT_ALIGNMENT;
+  }
+  else {
+    int tics;
+
+    tics = true_logictic - segment_start;
+
+    if (tics < segment_index * segment_length || tics % SEGMENT_ALIGNMENT)
+      return;
+  }
+
+  dsda_StoreKeyFrame(&key_frame, true, false);
+
+  key_frame_name = dsda_SegmentFileName(segment_index, ".kf");
+  dsda_WriteKeyFrame(&key_frame, key_frame_name);
+  Z_Free(key_frame_name);
+  Z_Free(key_frame.buffer);
+
+  // The previous segment ends where this one begins
+  if (segment_index)
+    dsda_StartSegment(segment_index - 1, true_logictic);
+
+  ++segment_index;
+}
+
+void dsda_UpdateViddumpSegments(void) {
+  static dboolean initialized;
+
+  if (!initialized) {
+    dsda_arg_t* arg;
+
+    initialized = true;
+
+    arg = dsda_Arg(dsda_arg_viddump_segment);
+    if (arg->found)
+      segment_end_tic = arg->value.v_int_array[1];
+  }
+
+  if (segment_end_tic && true_logictic >= segment_end_tic)
+    I_SafeExit(0);
+
+  if (segment_count)
+    dsda_UpdateSegmentDriver();
+}
@@ -0,0 +1,24 @@
+//
+// Copyright(C) 2026 by borogk
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//	DSDA Viddump Segments
+//
+
+#ifndef __DSDA_VIDDUMP_SEGMENTS__
+#define __DSDA_VIDDUMP_SEGMENTS__
+
+void dsda_InitViddumpSegments(const char* fn);
+void dsda_UpdateViddumpSegments(void);
+
+#endif
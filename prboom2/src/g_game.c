@@ -99,6 +99,7 @@
 #include "dsda/mapinfo.h"
 #include "dsda/messenger.h"
 #include "dsda/save.h"
+#include "dsda/seek_index.h"
 #include "dsda/settings.h"
 #include "dsda/input.h"
 #include "dsda/map_format.h"
@@ -109,10 +110,12 @@
 #include "dsda/playback.h"
 #include "dsda/skill_info.h"
 #include "dsda/skip.h"
+#include "dsda/sync_hash.h"
 #include "dsda/time.h"
 #include "dsda/tracker.h"
 #include "dsda/split_tracker.h"
 #include "dsda/utility.h"
+#include "dsda/viddump_segments.h"
 
 #include "cman.h"
 
@@ -1528,6 +1531,8 @@ void G_Ticker (void)
     int buf = gametic % BACKUPTICS;
 
     dsda_UpdateAutoKeyFrames();
+    dsda_UpdateSeekIndex();
+    dsda_UpdateViddumpSegments();
 
     if (dsda_BruteForce())
     {
@@ -1647,6 +1652,7 @@ void G_Ticker (void)
   {
     case GS_LEVEL:
       P_Ticker();
+      dsda_UpdateSyncHash();
       P_WalkTicker();
       mlooky = 0;
       AM_Ticker();
@@ -3940,6 +3946,9 @@ void G_DoPlayDemo(void)
                      defdemoname, comp_lev_str[compatibility_level]);
 
     gameaction = ga_nothing;
+
+    dsda_InitSeekIndex(demobuffer, demolength);
+    dsda_ContinuePlaybackKeyFrame();
   }
   else
   {
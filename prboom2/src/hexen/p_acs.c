@@ -23,6 +23,7 @@
 #include "w_wad.h"
 #include "lprintf.h"
 #include "r_main.h"
+#include "r_bsp.h"
 #include "p_tick.h"
 #include "p_spec.h"
 #include "p_inter.h"
@@ -1743,6 +1744,7 @@ static int CmdSetLineTexture(void)
             sides[line->sidenum[side]].toptexture = texture;
         }
     }
+    R_InvalidateBSPCache();
     return SCRIPT_CONTINUE;
 }
 
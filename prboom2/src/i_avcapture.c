@@ -0,0 +1,624 @@
+/* Emacs style mode select   -*- C -*-
+ *-----------------------------------------------------------------------------
+ *
+ *
+ *  PrBoom: a Doom port merged with LxDoom and LSDLDoom
+ *  based on BOOM, a modified and improved DOOM engine
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License
+ *  as published by the Free Software Foundation; either version 2
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+ *  02111-1307, USA.
+ *
+ * DESCRIPTION:
+ *  Built-in video capture encoder using the FFmpeg libraries.
+ *  Video and audio are encoded in-process and muxed straight into
+ *  the -viddump file, so no temp files or mux pass are needed.
+ *
+ *  Encoding doesn't touch the zone, so frames may be
+ *  encoded from the capture writer thread.
+ *
+ *---------------------------------------------------------------------
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "i_avcapture.h"
+
+#ifndef HAVE_LIBAV
+
+int I_AVCaptureAvailable (void)
+{
+  return 0;
+}
+
+int I_AVCaptureOpen (const char *fn, int width, int height, int fps, int samplerate)
+{
+  return 0;
+}
+
+int I_AVCaptureVideo (const unsigned char *data, int width, int height, grab_format_t format)
+{
+  return 0;
+}
+
+int I_AVCaptureAudio (const unsigned char *data, int samples)
+{
+  return 0;
+}
+
+void I_AVCaptureClose (void)
+{
+}
+
+#else // HAVE_LIBAV
+
+#include <string.h>
+
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+#include <libavutil/audio_fifo.h>
+#include <libavutil/channel_layout.h>
+#include <libavutil/samplefmt.h>
+#include <libswresample/swresample.h>
+#include <libswscale/swscale.h>
+
+#include "lprintf.h"
+
+#include "dsda/configuration.h"
+
+#if LIBAVUTIL_VERSION_INT >= AV_VERSION_INT(57, 28, 100)
+#define AV_CH_LAYOUT_API
+#endif
+
+typedef struct
+{
+  AVStream *stream;
+  AVCodecContext *ctx;
+  AVFrame *frame;
+  int64_t next_pts;
+} avstream_t;
+
+static AVFormatContext *oc;
+static AVPacket *pkt;
+static avstream_t vst;
+static avstream_t ast;
+
+static struct SwsContext *sws;
+
+// game audio is converted to the encoder's sample format and rate,
+// then collected until a full encoder frame is available
+static SwrContext *swr;
+static AVAudioFifo *fifo;
+static uint8_t **convbuf;
+static int convbuf_samples;
+static int audio_frame_size;
+
+int I_AVCaptureAvailable (void)
+{
+  return 1;
+}
+
+static void I_AVError (const char *what, int err)
+{
+  char buf[AV_ERROR_MAX_STRING_SIZE];
+
+  av_strerror (err, buf, sizeof(buf));
+  lprintf (LO_ERROR, "I_AVCapture: %s: %s\n", what, buf);
+}
+
+// send a frame (NULL to flush) and mux every packet that comes out
+static int I_AVEncode (avstream_t *st, AVFrame *frame)
+{
+  int err;
+
+  err = avcodec_send_frame (st->ctx, frame);
+  if (err < 0)
+  {
+    I_AVError ("send frame", err);
+    return 0;
+  }
+
+  while ((err = avcodec_receive_packet (st->ctx, pkt)) >= 0)
+  {
+    av_packet_rescale_ts (pkt, st->ctx->time_base, st->stream->time_base);
+    pkt->stream_index = st->stream->index;
+
+    err = av_interleaved_write_frame (oc, pkt);
+    if (err < 0)
+    {
+      I_AVError ("write packet", err);
+      return 0;
+    }
+  }
+
+  return err == AVERROR(EAGAIN) || err == AVERROR_EOF;
+}
+
+static const AVCodec *I_AVFindEncoder (int config, enum AVMediaType type)
+{
+  const char *name;
+  const AVCodec *codec;
+
+  name = dsda_StringConfig(config);
+  codec = avcodec_find_encoder_by_name (name);
+  if (!codec || codec->type != type)
+  {
+    lprintf (LO_ERROR, "I_AVCapture: encoder %s not found\n", name);
+    return NULL;
+  }
+
+  return codec;
+}
+
+static int I_AVOpenEncoder (avstream_t *st, const AVCodec *codec, const char *options)
+{
+  AVDictionary *opts = NULL;
+  int err;
+
+  if (oc->oformat->flags & AVFMT_GLOBALHEADER)
+    st->ctx->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
+
+  if (options && *options && av_dict_parse_string (&opts, options, "=", ":", 0) < 0)
+    lprintf (LO_WARN, "I_AVCapture: malformed encoder options %s\n", options);
+
+  err = avcodec_open2 (st->ctx, codec, &opts);
+  av_dict_free (&opts);
+  if (err < 0)
+  {
+    I_AVError (codec->name, err);
+    return 0;
+  }
+
+  err = avcodec_parameters_from_context (st->stream->codecpar, st->ctx);
+  if (err < 0)
+  {
+    I_AVError ("codec parameters", err);
+    return 0;
+  }
+  st->stream->time_base = st->ctx->time_base;
+
+  st->frame = av_frame_alloc ();
+  return st->frame != NULL;
+}
+
+static int I_AVOpenVideo (int width, int height, int fps)
+{
+  const AVCodec *codec;
+  int err;
+
+  codec = I_AVFindEncoder (dsda_config_cap_video_codec, AVMEDIA_TYPE_VIDEO);
+  if (!codec)
+    return 0;
+
+  vst.stream = avformat_new_stream (oc, NULL);
+  vst.ctx = avcodec_alloc_context3 (codec);
+  if (!vst.stream || !vst.ctx)
+    return 0;
+
+  // 4:2:0 chroma needs even dimensions
+  vst.ctx->width = width & ~1;
+  vst.ctx->height = height & ~1;
+  vst.ctx->pix_fmt = AV_PIX_FMT_YUV420P;
+  vst.ctx->time_base = (AVRational) { 1, fps };
+  vst.ctx->framerate = (AVRational) { fps, 1 };
+
+  if (!I_AVOpenEncoder (&vst, codec, dsda_StringConfig(dsda_config_cap_video_options)))
+    return 0;
+
+  vst.frame->format = vst.ctx->pix_fmt;
+  vst.frame->width = vst.ctx->width;
+  vst.frame->height = vst.ctx->height;
+
+  err = av_frame_get_buffer (vst.frame, 0);
+  if (err < 0)
+  {
+    I_AVError ("video frame", err);
+    return 0;
+  }
+
+  return 1;
+}
+
+// pick a sample format, 16 bit if the encoder takes it
+static enum AVSampleFormat I_AVSampleFormat (const AVCodec *codec)
+{
+  static const enum AVSampleFormat preferred[] = {
+    AV_SAMPLE_FMT_S16, AV_SAMPLE_FMT_S16P, AV_SAMPLE_FMT_FLT, AV_SAMPLE_FMT_FLTP
+  };
+  const enum AVSampleFormat *p;
+  int i;
+
+  if (!codec->sample_fmts)
+    return AV_SAMPLE_FMT_S16;
+
+  for (i = 0; i < sizeof(preferred) / sizeof(preferred[0]); i++)
+    for (p = codec->sample_fmts; *p != AV_SAMPLE_FMT_NONE; p++)
+      if (*p == preferred[i])
+        return *p;
+
+  return codec->sample_fmts[0];
+}
+
+// pick the game's rate if the encoder takes it, else the closest rate
+// above it (libopus only does 48000 and below, snd_samplerate is 44100)
+static int I_AVSampleRate (const AVCodec *codec, int samplerate)
+{
+  const int *rate;
+  int best = 0;
+
+  if (!codec->supported_samplerates)
+    return samplerate;
+
+  for (rate = codec->supported_samplerates; *rate; rate++)
+  {
+    if (*rate == samplerate)
+      return samplerate;
+
+    if (!best ||
+        (*rate > samplerate && (best < samplerate || *rate < best)) ||
+        (*rate < samplerate && best < samplerate && *rate > best))
+      best = *rate;
+  }
+
+  return best;
+}
+
+static int I_AVOpenResampler (int samplerate)
+{
+  int err;
+
+#ifdef AV_CH_LAYOUT_API
+  AVChannelLayout stereo = AV_CHANNEL_LAYOUT_STEREO;
+
+  err = swr_alloc_set_opts2 (&swr,
+                             &ast.ctx->ch_layout, ast.ctx->sample_fmt, ast.ctx->sample_rate,
+                             &stereo, AV_SAMPLE_FMT_S16, samplerate,
+                             0, NULL);
+  if (err < 0)
+  {
+    I_AVError ("resampler", err);
+    return 0;
+  }
+#else
+  swr = swr_alloc_set_opts (NULL,
+                            AV_CH_LAYOUT_STEREO, ast.ctx->sample_fmt, ast.ctx->sample_rate,
+                            AV_CH_LAYOUT_STEREO, AV_SAMPLE_FMT_S16, samplerate,
+                            0, NULL);
+  if (!swr)
+  {
+    lprintf (LO_ERROR, "I_AVCapture: resampler: out of memory\n");
+    return 0;
+  }
+#endif
+
+  err = swr_init (swr);
+  if (err < 0)
+  {
+    I_AVError ("resampler", err);
+    return 0;
+  }
+
+  if (ast.ctx->sample_rate != samplerate)
+    lprintf (LO_INFO, "I_AVCapture: resampling audio from %d to %d hz for %s\n",
+             samplerate, ast.ctx->sample_rate, ast.ctx->codec->name);
+
+  return 1;
+}
+
+static int I_AVOpenAudio (int samplerate)
+{
+  const AVCodec *codec;
+  enum AVSampleFormat sample_fmt;
+  int encoder_rate;
+  int err;
+
+  codec = I_AVFindEncoder (dsda_config_cap_audio_codec, AVMEDIA_TYPE_AUDIO);
+  if (!codec)
+    return 0;
+
+  sample_fmt = I_AVSampleFormat (codec);
+  if (sample_fmt == AV_SAMPLE_FMT_NONE)
+  {
+    lprintf (LO_ERROR, "I_AVCapture: %s has no supported sample format\n", codec->name);
+    return 0;
+  }
+
+  encoder_rate = I_AVSampleRate (codec, samplerate);
+
+  ast.stream = avformat_new_stream (oc, NULL);
+  ast.ctx = avcodec_alloc_context3 (codec);
+  if (!ast.stream || !ast.ctx)
+    return 0;
+
+  ast.ctx->sample_fmt = sample_fmt;
+  ast.ctx->sample_rate = encoder_rate;
+  ast.ctx->time_base = (AVRational) { 1, encoder_rate };
+#ifdef AV_CH_LAYOUT_API
+  av_channel_layout_default (&ast.ctx->ch_layout, 2);
+#else
+  ast.ctx->channels = 2;
+  ast.ctx->channel_layout = AV_CH_LAYOUT_STEREO;
+#endif
+
+  if (!I_AVOpenEncoder (&ast, codec, NULL))
+    return 0;
+
+  audio_frame_size = ast.ctx->frame_size;
+  if (!audio_frame_size || (codec->capabilities & AV_CODEC_CAP_VARIABLE_FRAME_SIZE))
+    audio_frame_size = 1024;
+
+  ast.frame->format = ast.ctx->sample_fmt;
+  ast.frame->sample_rate = encoder_rate;
+  ast.frame->nb_samples = audio_frame_size;
+#ifdef AV_CH_LAYOUT_API
+  av_channel_layout_copy (&ast.frame->ch_layout, &ast.ctx->ch_layout);
+#else
+  ast.frame->channel_layout = ast.ctx->channel_layout;
+#endif
+
+  err = av_frame_get_buffer (ast.frame, 0);
+  if (err < 0)
+  {
+    I_AVError ("audio frame", err);
+    return 0;
+  }
+
+  if (!I_AVOpenResampler (samplerate))
+    return 0;
+
+  fifo = av_audio_fifo_alloc (ast.ctx->sample_fmt, 2, audio_frame_size);
+  return fifo != NULL;
+}
+
+static void I_AVFreeStream (avstream_t *st)
+{
+  avcodec_free_context (&st->ctx);
+  av_frame_free (&st->frame);
+  memset (st, 0, sizeof(*st));
+}
+
+static void I_AVFree (void)
+{
+  if (oc)
+  {
+    if (oc->pb && !(oc->oformat->flags & AVFMT_NOFILE))
+      avio_closep (&oc->pb);
+    avformat_free_context (oc);
+    oc = NULL;
+  }
+
+  I_AVFreeStream (&vst);
+  I_AVFreeStream (&ast);
+  av_packet_free (&pkt);
+
+  sws_freeContext (sws);
+  sws = NULL;
+
+  swr_free (&swr);
+
+  if (fifo)
+  {
+    av_audio_fifo_free (fifo);
+    fifo = NULL;
+  }
+
+  if (convbuf)
+  {
+    av_freep (&convbuf[0]);
+    av_freep (&convbuf);
+  }
+  convbuf_samples = 0;
+}
+
+int I_AVCaptureOpen (const char *fn, int width, int height, int fps, int samplerate)
+{
+  int err;
+
+  err = avformat_alloc_output_context2 (&oc, NULL, NULL, fn);
+  if (err < 0)
+  {
+    I_AVError (fn, err);
+    return 0;
+  }
+
+  pkt = av_packet_alloc ();
+  if (!pkt || !I_AVOpenVideo (width, height, fps) || !I_AVOpenAudio (samplerate))
+  {
+    I_AVFree ();
+    return 0;
+  }
+
+  if (!(oc->oformat->flags & AVFMT_NOFILE))
+  {
+    err = avio_open (&oc->pb, fn, AVIO_FLAG_WRITE);
+    if (err < 0)
+    {
+      I_AVError (fn, err);
+      I_AVFree ();
+      return 0;
+    }
+  }
+
+  err = avformat_write_header (oc, NULL);
+  if (err < 0)
+  {
+    I_AVError ("write header", err);
+    I_AVFree ();
+    return 0;
+  }
+
+  lprintf (LO_INFO, "I_AVCaptureOpen: encoding %s with %s and %s\n",
+           fn, vst.ctx->codec->name, ast.ctx->codec->name);
+  return 1;
+}
+
+int I_AVCaptureVideo (const unsigned char *data, int width, int height, grab_format_t format)
+{
+  const uint8_t *src[4] = { NULL };
+  int stride[4] = { 0 };
+  enum AVPixelFormat src_fmt;
+  int err;
+
+  if (!oc)
+    return 0;
+
+  if (format == grab_format_yuv420p)
+  {
+    int cw = (width + 1) >> 1;
+    int ch = (height + 1) >> 1;
+
+    src_fmt = AV_PIX_FMT_YUV420P;
+    src[0] = data;
+    src[1] = src[0] + width * height;
+    src[2] = src[1] + cw * ch;
+    stride[0] = width;
+    stride[1] = stride[2] = cw;
+  }
+  else
+  {
+    src_fmt = AV_PIX_FMT_RGB24;
+    src[0] = data;
+    stride[0] = width * 3;
+  }
+
+  // the window can be resized while capturing, frames are scaled to the opened size
+  sws = sws_getCachedContext (sws, width, height, src_fmt,
+                              vst.ctx->width, vst.ctx->height, vst.ctx->pix_fmt,
+                              SWS_BILINEAR, NULL, NULL, NULL);
+  if (!sws)
+  {
+    lprintf (LO_ERROR, "I_AVCaptureVideo: no conversion from %dx%d\n", width, height);
+    return 0;
+  }
+
+  err = av_frame_make_writable (vst.frame);
+  if (err < 0)
+  {
+    I_AVError ("video frame", err);
+    return 0;
+  }
+
+  sws_scale (sws, src, stride, 0, height, vst.frame->data, vst.frame->linesize);
+  vst.frame->pts = vst.next_pts++;
+
+  return I_AVEncode (&vst, vst.frame);
+}
+
+// encode one frame worth of samples from the fifo
+// a short final frame is padded with silence unless the encoder accepts it
+static int I_AVEncodeAudioFrame (int samples)
+{
+  int err;
+
+  err = av_frame_make_writable (ast.frame);
+  if (err < 0)
+  {
+    I_AVError ("audio frame", err);
+    return 0;
+  }
+
+  samples = av_audio_fifo_read (fifo, (void **) ast.frame->data, samples);
+  if (samples < audio_frame_size &&
+      !(ast.ctx->codec->capabilities & (AV_CODEC_CAP_SMALL_LAST_FRAME | AV_CODEC_CAP_VARIABLE_FRAME_SIZE)))
+  {
+    av_samples_set_silence (ast.frame->data, samples, audio_frame_size - samples,
+                            2, ast.ctx->sample_fmt);
+    samples = audio_frame_size;
+  }
+
+  ast.frame->nb_samples = samples;
+  ast.frame->pts = ast.next_pts;
+  ast.next_pts += samples;
+
+  return I_AVEncode (&ast, ast.frame);
+}
+
+// convert samples (NULL to drain the resampler) into the fifo
+// and encode every full frame
+static int I_AVResampleAudio (const unsigned char *data, int samples)
+{
+  const uint8_t *in[1];
+  int out_samples;
+
+  out_samples = swr_get_out_samples (swr, samples);
+  if (out_samples < 0)
+    return 0;
+
+  if (out_samples > convbuf_samples)
+  {
+    if (convbuf)
+    {
+      av_freep (&convbuf[0]);
+      av_freep (&convbuf);
+    }
+    if (av_samples_alloc_array_and_samples (&convbuf, NULL, 2, out_samples, ast.ctx->sample_fmt, 0) < 0)
+    {
+      convbuf_samples = 0;
+      return 0;
+    }
+    convbuf_samples = out_samples;
+  }
+
+  in[0] = data;
+  out_samples = swr_convert (swr, convbuf, convbuf_samples, data ? in : NULL, samples);
+  if (out_samples < 0)
+  {
+    I_AVError ("resample", out_samples);
+    return 0;
+  }
+
+  if (av_audio_fifo_write (fifo, (void **) convbuf, out_samples) < out_samples)
+    return 0;
+
+  while (av_audio_fifo_size (fifo) >= audio_frame_size)
+    if (!I_AVEncodeAudioFrame (audio_frame_size))
+      return 0;
+
+  return 1;
+}
+
+int I_AVCaptureAudio (const unsigned char *data, int samples)
+{
+  if (!oc)
+    return 0;
+
+  return I_AVResampleAudio (data, samples);
+}
+
+void I_AVCaptureClose (void)
+{
+  int err;
+
+  if (!oc)
+    return;
+
+  // the resampler holds back a few samples of filter delay
+  I_AVResampleAudio (NULL, 0);
+
+  if (av_audio_fifo_size (fifo) > 0)
+    I_AVEncodeAudioFrame (av_audio_fifo_size (fifo));
+
+  I_AVEncode (&vst, NULL);
+  I_AVEncode (&ast, NULL);
+
+  err = av_write_trailer (oc);
+  if (err < 0)
+    I_AVError ("write trailer", err);
+
+  I_AVFree ();
+}
+
+#endif // HAVE_LIBAV
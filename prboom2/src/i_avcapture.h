@@ -0,0 +1,53 @@
+/* Emacs style mode select   -*- C -*-
+ *-----------------------------------------------------------------------------
+ *
+ *
+ *  PrBoom: a Doom port merged with LxDoom and LSDLDoom
+ *  based on BOOM, a modified and improved DOOM engine
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License
+ *  as published by the Free Software Foundation; either version 2
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+ *  02111-1307, USA.
+ *
+ * DESCRIPTION:
+ *  Built-in video capture encoder using the FFmpeg libraries
+ *
+ *---------------------------------------------------------------------
+ */
+
+#ifndef __I_AVCAPTURE__
+#define __I_AVCAPTURE__
+
+#include "i_video.h"
+
+// 1 if the encoder is compiled in
+int I_AVCaptureAvailable (void);
+
+// open fn and set up the video and audio encoders
+// returns 1 on success
+int I_AVCaptureOpen (const char *fn, int width, int height, int fps, int samplerate);
+
+// encode one video frame (rgb24 or yuv420p, scaled to the opened size if needed)
+// returns 1 on success
+int I_AVCaptureVideo (const unsigned char *data, int width, int height, grab_format_t format);
+
+// encode interleaved signed 16 bit stereo samples at the opened rate,
+// resampled to a rate the audio encoder supports
+// returns 1 on success
+int I_AVCaptureAudio (const unsigned char *data, int samples);
+
+// flush the encoders and finish the file
+void I_AVCaptureClose (void);
+
+#endif
@@ -33,21 +33,34 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "i_sound.h"
 #include "i_video.h"
 #include "lprintf.h"
 #include "m_file.h"
 #include "i_system.h"
 #include "i_capture.h"
+#include "i_avcapture.h"
+#include "doomdef.h"
+#include "v_video.h"
+#include "z_zone.h"
 
+#include "dsda/args.h"
 #include "dsda/configuration.h"
+#include "dsda/utility.h"
 
 int capturing_video = 0;
 static const char *vid_fname;
 
+// list of segment files passed to cap_concatcommand
+static const char *vid_listname;
+
+// commands can hold several file names, so allow more than one path
+#define CAPTURE_COMMAND_MAX 8192
+
 typedef struct
 { // information on a running pipe
-  char command[PATH_MAX];
+  char command[CAPTURE_COMMAND_MAX];
   FILE *f_stdin;
   FILE *f_stdout;
   FILE *f_stderr;
@@ -66,12 +79,49 @@ int cap_fps;
 int cap_frac;
 int cap_wipescreen;
 
+// frames grabbed straight from the 8-bit software buffer
+// cap_direct_format: 0 = read back from renderer, 1 = rgb24, 2 = yuv420p
+static int cap_direct;
+static grab_format_t cap_direct_format;
+
+// direct frames are enlarged by this factor, so the game can render
+// at a fraction of the video size
+static int cap_direct_scale = 1;
+
+// frames go to the built-in encoder instead of the command pipes
+static int cap_libav;
+
+// dimensions and byte size of a captured video frame
+static int cap_width;
+static int cap_height;
+static int cap_frame_size;
+
+static void I_UpdateCaptureSize (void)
+{
+  if (cap_direct)
+  {
+    cap_width = SCREENWIDTH * cap_direct_scale;
+    cap_height = SCREENHEIGHT * cap_direct_scale;
+    cap_frame_size = I_GrabScreenIndexedSize (cap_direct_format, cap_direct_scale);
+  }
+  else
+  {
+    I_UpdateRenderSize(); // Handle potential resolution scaling - DTIED
+    cap_width = renderW;
+    cap_height = renderH;
+    cap_frame_size = renderW * renderH * 3;
+  }
+}
+
 // parses a command with simple printf-style replacements.
 
 // %w video width (px)
 // %h video height (px)
 // %s sound rate (hz)
 // %f filename passed to -viddump
+// %r video frame rate
+// %p video pixel format (rgb24 or yuv420p)
+// %l list of segment files (concat command only)
 // %% single percent sign
 // TODO: add aspect ratio information
 //
@@ -84,14 +134,18 @@ static int parsecommand (char *out, const char *in, int len)
   {
     if (*in == '%')
     {
-      I_UpdateRenderSize(); // Handle potential resolution scaling - DTIED
+      I_UpdateCaptureSize();
       switch (in[1])
       {
         case 'w':
-          i = snprintf (out, len, "%u", renderW);
+          i = snprintf (out, len, "%u", cap_width);
           break;
         case 'h':
-          i = snprintf (out, len, "%u", renderH);
+          i = snprintf (out, len, "%u", cap_height);
+          break;
+        case 'p':
+          i = snprintf (out, len, "%s",
+            cap_direct && cap_direct_format == grab_format_yuv420p ? "yuv420p" : "rgb24");
           break;
         case 's':
           i = snprintf (out, len, "%u", snd_samplerate);
@@ -102,6 +156,11 @@ static int parsecommand (char *out, const char *in, int len)
         case 'r':
           i = snprintf (out, len, "%u", cap_fps);
           break;
+        case 'l':
+          if (!vid_listname)
+            return 0;
+          i = snprintf (out, len, "%s", vid_listname);
+          break;
         case '%':
           i = snprintf (out, len, "%%");
           break;
@@ -127,6 +186,67 @@ static int parsecommand (char *out, const char *in, int len)
 }
 
 
+// parallel segment rendering: each segment process writes its own temp files.
+// temp_a.nut becomes temp_a-seg03.nut
+static char cap_segment_suffix[16];
+
+static char *I_SegmentFileName (const char *name)
+{
+  const char *ext;
+  char *out;
+  size_t len;
+
+  ext = strrchr (name, '.');
+  if (!ext || strpbrk (ext, "/\\"))
+    ext = name + strlen (name);
+
+  len = strlen (name) + strlen (cap_segment_suffix) + 1;
+  out = Z_Malloc (len);
+  snprintf (out, len, "%.*s%s%s", (int) (ext - name), name, cap_segment_suffix, ext);
+
+  return out;
+}
+
+// replaces every occurrence of name in command with its segment file name
+static int I_SegmentCommand (char *command, int len, const char *name)
+{
+  dsda_string_t str;
+  const char *p;
+  const char *match;
+  char *segment_name;
+  size_t name_len;
+  int result;
+
+  name_len = strlen (name);
+  if (!cap_segment_suffix[0] || !name_len)
+    return 1;
+
+  segment_name = I_SegmentFileName (name);
+  dsda_InitString (&str, NULL);
+
+  for (p = command; (match = strstr (p, name)); p = match + name_len)
+    dsda_StringCatF (&str, "%.*s%s", (int) (match - p), p, segment_name);
+  dsda_StringCat (&str, p);
+
+  result = strlen (str.string) < (size_t) len;
+  if (result)
+    strcpy (command, str.string);
+
+  dsda_FreeString (&str);
+  Z_Free (segment_name);
+
+  return result;
+}
+
+static const char *I_SegmentDumpName (const char *name)
+{
+  if (!cap_segment_suffix[0])
+    return name;
+
+  return I_SegmentFileName (name);
+}
+
+
 
 
 // popen3() implementation -
@@ -134,8 +254,8 @@ static int parsecommand (char *out, const char *in, int len)
 
 // user is a pointer to implementation defined extra data
 static int my_popen3 (pipeinfo_t *p); // 1 on success
-// close waits on process
-static void my_pclose3 (pipeinfo_t *p);
+// close waits on process, returns its exit status (-1 if unknown)
+static int my_pclose3 (pipeinfo_t *p);
 
 
 #ifdef _WIN32
@@ -289,12 +409,14 @@ static int my_popen3 (pipeinfo_t *p)
 
 }
 
-static void my_pclose3 (pipeinfo_t *p)
+static int my_pclose3 (pipeinfo_t *p)
 {
   puser_t *puser = (puser_t *) p->user;
+  DWORD code;
+  int status = -1;
 
   if (!p->f_stdin || !p->f_stdout || !p->f_stderr || !puser)
-    return;
+    return -1;
 
   fclose (p->f_stdin);
   //fclose (p->f_stdout); // these are closed elsewhere
@@ -302,9 +424,14 @@ static void my_pclose3 (pipeinfo_t *p)
 
   WaitForSingleObject (puser->proc, INFINITE);
 
+  if (GetExitCodeProcess (puser->proc, &code))
+    status = (int) code;
+
   CloseHandle (puser->proc);
   CloseHandle (puser->thread);
   Z_Free (puser);
+
+  return status;
 }
 
 #else // _WIN32
@@ -419,22 +546,26 @@ static int my_popen3 (pipeinfo_t *p)
 }
 
 
-static void my_pclose3 (pipeinfo_t *p)
+static int my_pclose3 (pipeinfo_t *p)
 {
   puser_t *puser = (puser_t *) p->user;
 
   int s;
+  int status = -1;
 
   if (!p->f_stdin || !p->f_stdout || !p->f_stderr || !puser)
-    return;
+    return -1;
 
   fclose (p->f_stdin);
   //fclose (p->f_stdout); // these are closed elsewhere
   //fclose (p->f_stderr);
 
-  waitpid (puser->pid, &s, 0);
+  if (waitpid (puser->pid, &s, 0) == puser->pid && WIFEXITED (s))
+    status = WEXITSTATUS (s);
 
   Z_Free (puser);
+
+  return status;
 }
 
 
@@ -488,6 +619,259 @@ static int threadstderrproc (void *data)
 }
 
 
+// frame ring shared between the game loop and the writer thread
+typedef struct
+{
+  unsigned char *snd;
+  size_t snd_len;
+  size_t snd_size;
+  unsigned char *vid;
+  size_t vid_len;
+  size_t vid_size;
+  int vid_width;
+  int vid_height;
+  // direct frames are queued as the 8-bit buffer and its palette,
+  // and converted into vid by the writer thread
+  dboolean convert;
+  unsigned char *raw;
+  size_t raw_size;
+  int raw_width;
+  int raw_height;
+  SDL_Color palette[256];
+} capframe_t;
+
+static capframe_t *capframes;
+static int capframes_count;
+static int capframes_head; // next slot filled by the game loop
+static int capframes_tail; // next slot written by the writer thread
+static int capframes_used;
+static int capthread_quit;
+static SDL_mutex *capmutex;
+static SDL_cond *capcond;
+static SDL_Thread *capthread;
+
+static void I_WriteCaptureFrame (const capframe_t *frame)
+{
+  if (cap_libav)
+  {
+    grab_format_t format = cap_direct ? cap_direct_format : grab_format_rgb24;
+
+    if (frame->snd_len && !I_AVCaptureAudio (frame->snd, frame->snd_len / 4))
+      lprintf(LO_WARN, "I_CaptureFrame: error encoding sound.\n");
+    if (frame->vid_len && !I_AVCaptureVideo (frame->vid, frame->vid_width, frame->vid_height, format))
+      lprintf(LO_WARN, "I_CaptureFrame: error encoding video.\n");
+    return;
+  }
+
+  if (frame->snd_len && fwrite (frame->snd, frame->snd_len, 1, soundpipe.f_stdin) != 1)
+    lprintf(LO_WARN, "I_CaptureFrame: error writing soundpipe.\n");
+  if (frame->vid_len && fwrite (frame->vid, frame->vid_len, 1, videopipe.f_stdin) != 1)
+    lprintf(LO_WARN, "I_CaptureFrame: error writing videopipe.\n");
+}
+
+static int threadwriterproc (void *data)
+{ // feeds queued frames into the sound and video pipes or the encoder
+  capframe_t *frame;
+
+  while (1)
+  {
+    SDL_LockMutex (capmutex);
+    while (!capframes_used && !capthread_quit)
+      SDL_CondWait (capcond, capmutex);
+    if (!capframes_used)
+    { // quit requested and the queue is drained
+      SDL_UnlockMutex (capmutex);
+      break;
+    }
+    frame = &capframes[capframes_tail];
+    SDL_UnlockMutex (capmutex);
+
+    // frames are converted and written without holding the lock,
+    // so the game loop can keep simulating and drawing the next ones
+    if (frame->convert)
+      I_ConvertScreenIndexed (frame->vid, frame->raw, frame->raw_width,
+                              frame->raw_width, frame->raw_height, cap_direct_scale,
+                              frame->palette, cap_direct_format);
+    I_WriteCaptureFrame (frame);
+
+    SDL_LockMutex (capmutex);
+    capframes_tail = (capframes_tail + 1) % capframes_count;
+    capframes_used--;
+    SDL_CondBroadcast (capcond);
+    SDL_UnlockMutex (capmutex);
+  }
+
+  return 1;
+}
+
+static void I_StartCaptureWriter (void)
+{
+  capframes_count = dsda_IntConfig(dsda_config_cap_queue_frames);
+  capframes = (capframe_t *) Z_Calloc (capframes_count, sizeof (*capframes));
+  capframes_head = capframes_tail = capframes_used = 0;
+  capthread_quit = 0;
+
+  capmutex = SDL_CreateMutex ();
+  capcond = SDL_CreateCond ();
+  if (capmutex && capcond)
+    capthread = SDL_CreateThread (threadwriterproc, "capthread", NULL);
+
+  if (!capthread)
+    lprintf (LO_WARN, "I_CapturePrep: writer thread failed, frames will be written synchronously\n");
+}
+
+// waits until every queued frame is written, then stops the writer thread
+static void I_StopCaptureWriter (void)
+{
+  int i, s;
+
+  if (capthread)
+  {
+    SDL_LockMutex (capmutex);
+    capthread_quit = 1;
+    SDL_CondBroadcast (capcond);
+    SDL_UnlockMutex (capmutex);
+
+    SDL_WaitThread (capthread, &s);
+    capthread = NULL;
+  }
+
+  if (capcond)
+  {
+    SDL_DestroyCond (capcond);
+    capcond = NULL;
+  }
+  if (capmutex)
+  {
+    SDL_DestroyMutex (capmutex);
+    capmutex = NULL;
+  }
+
+  for (i = 0; i < capframes_count; i++)
+  {
+    Z_Free (capframes[i].snd);
+    Z_Free (capframes[i].vid);
+    Z_Free (capframes[i].raw);
+  }
+  Z_Free (capframes);
+  capframes = NULL;
+  capframes_count = 0;
+}
+
+
+// helper processes (segment renderers) started by this process
+static pipeinfo_t **cap_processes;
+static int cap_process_count;
+
+int I_CaptureStartProcess (const char *command, const char *dumpname)
+{
+  pipeinfo_t *p;
+  size_t len;
+  char *name;
+
+  if (strlen (command) >= sizeof (p->command))
+  {
+    lprintf (LO_ERROR, "I_CaptureStartProcess: command too long\n");
+    return 0;
+  }
+
+  p = Z_Calloc (1, sizeof (*p));
+  strcpy (p->command, command);
+
+  lprintf (LO_INFO, "I_CaptureStartProcess: opening pipe \"%s\"\n", p->command);
+  if (!my_popen3 (p))
+  {
+    lprintf (LO_ERROR, "I_CaptureStartProcess: pipe failed\n");
+    Z_Free (p);
+    return 0;
+  }
+
+  len = strlen (dumpname) + sizeof ("_stdout.txt");
+  name = Z_Malloc (len);
+  snprintf (name, len, "%s_stdout.txt", dumpname);
+  p->stdoutdumpname = name;
+  name = Z_Malloc (len);
+  snprintf (name, len, "%s_stderr.txt", dumpname);
+  p->stderrdumpname = name;
+
+  p->outthread = SDL_CreateThread (threadstdoutproc, "process.outthread", p);
+  p->errthread = SDL_CreateThread (threadstderrproc, "process.errthread", p);
+
+  cap_processes = Z_Realloc (cap_processes, (cap_process_count + 1) * sizeof (*cap_processes));
+  cap_processes[cap_process_count++] = p;
+
+  return 1;
+}
+
+int I_CaptureWaitProcesses (void)
+{
+  int i;
+  int s;
+  int status;
+  int failed = 0;
+
+  for (i = 0; i < cap_process_count; i++)
+  {
+    pipeinfo_t *p = cap_processes[i];
+
+    status = my_pclose3 (p);
+    if (status)
+    {
+      lprintf (LO_ERROR, "I_CaptureWaitProcesses: process %d exited with status %d (see %s)\n",
+               i, status, p->stderrdumpname);
+      failed++;
+    }
+
+    SDL_WaitThread (p->outthread, &s);
+    SDL_WaitThread (p->errthread, &s);
+
+    Z_Free ((char *) p->stdoutdumpname);
+    Z_Free ((char *) p->stderrdumpname);
+    Z_Free (p);
+  }
+
+  Z_Free (cap_processes);
+  cap_processes = NULL;
+  cap_process_count = 0;
+
+  return failed;
+}
+
+// join the files named in listname into fn
+void I_CaptureConcat (const char *fn, const char *listname)
+{
+  const char *cap_concatcommand;
+  int s;
+
+  cap_concatcommand = dsda_StringConfig(dsda_config_cap_concatcommand);
+
+  vid_fname = fn;
+  vid_listname = listname;
+
+  if (!parsecommand (muxpipe.command, cap_concatcommand, sizeof(muxpipe.command)))
+  {
+    lprintf (LO_ERROR, "I_CaptureConcat: malformed command %s\n", cap_concatcommand);
+    return;
+  }
+
+  lprintf (LO_INFO, "I_CaptureConcat: opening pipe \"%s\"\n", muxpipe.command);
+  if (!my_popen3 (&muxpipe))
+  {
+    lprintf (LO_ERROR, "I_CaptureConcat: concat pipe failed\n");
+    return;
+  }
+
+  muxpipe.stdoutdumpname = "concat_stdout.txt";
+  muxpipe.stderrdumpname = "concat_stderr.txt";
+  muxpipe.outthread = SDL_CreateThread (threadstdoutproc, "muxpipe.outthread", &muxpipe);
+  muxpipe.errthread = SDL_CreateThread (threadstderrproc, "muxpipe.errthread", &muxpipe);
+
+  my_pclose3 (&muxpipe);
+  SDL_WaitThread (muxpipe.outthread, &s);
+  SDL_WaitThread (muxpipe.errthread, &s);
+}
+
+
 // init and open sound, video pipes
 // fn is filename passed from command line, typically final output file
 void I_CapturePrep (const char *fn)
@@ -502,8 +886,43 @@ void I_CapturePrep (const char *fn)
   cap_wipescreen = dsda_IntConfig(dsda_config_cap_wipescreen);
   cap_fps = dsda_IntConfig(dsda_config_cap_fps);
 
+  // direct grabbing needs the software renderer's 8-bit buffer
+  cap_direct = V_IsSoftwareMode() && dsda_IntConfig(dsda_config_cap_direct_format);
+  cap_direct_format = dsda_IntConfig(dsda_config_cap_direct_format) == 2 ?
+                      grab_format_yuv420p : grab_format_rgb24;
+  cap_direct_scale = dsda_IntConfig(dsda_config_cap_direct_scale);
+
   vid_fname = fn;
 
+  {
+    dsda_arg_t *arg;
+
+    arg = dsda_Arg(dsda_arg_viddump_segment);
+    if (arg->found)
+      snprintf (cap_segment_suffix, sizeof(cap_segment_suffix), "-seg%02d", arg->value.v_int_array[0]);
+  }
+
+  // the built-in encoder writes fn directly, without temp files or a mux pass
+  cap_libav = 0;
+  if (dsda_IntConfig(dsda_config_cap_builtin_encoder) && I_AVCaptureAvailable ())
+  {
+    I_UpdateCaptureSize ();
+    if (I_AVCaptureOpen (fn, cap_width, cap_height, cap_fps, snd_samplerate))
+    {
+      cap_libav = 1;
+      I_SetSoundCap ();
+      lprintf (LO_INFO, "I_CapturePrep: video capture started\n");
+      capturing_video = 1;
+
+      I_StartCaptureWriter ();
+
+      I_AtExit (I_CaptureFinish, true, "I_CaptureFinish", exit_priority_normal);
+      return;
+    }
+
+    lprintf (LO_WARN, "I_CapturePrep: built-in encoder failed, using capture commands\n");
+  }
+
   if (!parsecommand (soundpipe.command, cap_soundcommand, sizeof(soundpipe.command)))
   {
     lprintf (LO_ERROR, "I_CapturePrep: malformed command %s\n", cap_soundcommand);
@@ -523,6 +942,27 @@ void I_CapturePrep (const char *fn)
     return;
   }
 
+  if (cap_segment_suffix[0])
+  {
+    const char *cap_tempfile1;
+    const char *cap_tempfile2;
+
+    cap_tempfile1 = dsda_StringConfig(dsda_config_cap_tempfile1);
+    cap_tempfile2 = dsda_StringConfig(dsda_config_cap_tempfile2);
+
+    if (!I_SegmentCommand (soundpipe.command, sizeof(soundpipe.command), cap_tempfile1) ||
+        !I_SegmentCommand (soundpipe.command, sizeof(soundpipe.command), cap_tempfile2) ||
+        !I_SegmentCommand (videopipe.command, sizeof(videopipe.command), cap_tempfile1) ||
+        !I_SegmentCommand (videopipe.command, sizeof(videopipe.command), cap_tempfile2) ||
+        !I_SegmentCommand (muxpipe.command, sizeof(muxpipe.command), cap_tempfile1) ||
+        !I_SegmentCommand (muxpipe.command, sizeof(muxpipe.command), cap_tempfile2))
+    {
+      lprintf (LO_ERROR, "I_CapturePrep: segment command too long\n");
+      capturing_video = 0;
+      return;
+    }
+  }
+
   lprintf (LO_INFO, "I_CapturePrep: opening pipe \"%s\"\n", soundpipe.command);
   if (!my_popen3 (&soundpipe))
   {
@@ -543,22 +983,24 @@ void I_CapturePrep (const char *fn)
   capturing_video = 1;
 
   // start reader threads
-  soundpipe.stdoutdumpname = "sound_stdout.txt";
-  soundpipe.stderrdumpname = "sound_stderr.txt";
+  soundpipe.stdoutdumpname = I_SegmentDumpName ("sound_stdout.txt");
+  soundpipe.stderrdumpname = I_SegmentDumpName ("sound_stderr.txt");
   soundpipe.outthread = SDL_CreateThread (threadstdoutproc, "soundpipe.outthread", &soundpipe);
   soundpipe.errthread = SDL_CreateThread (threadstderrproc, "soundpipe.errthread", &soundpipe);
-  videopipe.stdoutdumpname = "video_stdout.txt";
-  videopipe.stderrdumpname = "video_stderr.txt";
+  videopipe.stdoutdumpname = I_SegmentDumpName ("video_stdout.txt");
+  videopipe.stderrdumpname = I_SegmentDumpName ("video_stderr.txt");
   videopipe.outthread = SDL_CreateThread (threadstdoutproc, "videopipe.outthread", &videopipe);
   videopipe.errthread = SDL_CreateThread (threadstderrproc, "videopipe.errthread", &videopipe);
 
+  I_StartCaptureWriter ();
+
   I_AtExit (I_CaptureFinish, true, "I_CaptureFinish", exit_priority_normal);
 }
 
 
 
 // capture a single frame of video (and corresponding audio length)
-// and send it to pipes
+// and hand it off to the writer thread
 // Modified to work with SDL2 resizeable window and fullscreen desktop - DTIED
 void I_CaptureFrame (void)
 {
@@ -566,6 +1008,8 @@ void I_CaptureFrame (void)
   unsigned char *vid;
   static int partsof35 = 0; // correct for sync when samplerate % 35 != 0
   int nsampreq;
+  dboolean convert;
+  capframe_t *frame;
 
   if (!capturing_video)
     return;
@@ -579,20 +1023,91 @@ void I_CaptureFrame (void)
   }
 
   snd = I_GrabSound (nsampreq);
-  if (snd)
+
+  // with the writer thread running, direct frames are only copied here
+  // and the colour conversion overlaps with the next tics
+  convert = capthread && cap_direct && V_IsSoftwareMode () && screens[0].data;
+
+  if (convert)
+  {
+    vid = NULL;
+  }
+  else if (cap_direct)
   {
-    if (fwrite (snd, nsampreq * 4, 1, soundpipe.f_stdin) != 1)
-      lprintf(LO_WARN, "I_CaptureFrame: error writing soundpipe.\n");
-    //Z_Free (snd); // static buffer
+    vid = I_GrabScreenIndexed (cap_direct_format, cap_direct_scale);
   }
-  vid = I_GrabScreen ();
-  if (vid)
+  else
   {
-    if (fwrite (vid, renderW * renderH * 3, 1, videopipe.f_stdin) != 1)
-      lprintf(LO_WARN, "I_CaptureFrame: error writing videopipe.\n");
-    //Z_Free (vid); // static buffer
+    vid = I_GrabScreen ();
+  }
+  I_UpdateCaptureSize ();
+
+  if (!capthread)
+  { // writer thread isn't running, write directly
+    capframe_t direct;
+
+    direct.snd = snd;
+    direct.snd_len = snd ? nsampreq * 4 : 0;
+    direct.vid = vid;
+    direct.vid_len = vid ? cap_frame_size : 0;
+    direct.vid_width = cap_width;
+    direct.vid_height = cap_height;
+    I_WriteCaptureFrame (&direct);
+    return;
   }
 
+  // wait for a free slot
+  SDL_LockMutex (capmutex);
+  while (capframes_used == capframes_count)
+    SDL_CondWait (capcond, capmutex);
+  frame = &capframes[capframes_head];
+  SDL_UnlockMutex (capmutex);
+
+  // the slot is owned by the main thread until it is queued,
+  // so buffers can be (re)allocated here without locking
+  frame->snd_len = snd ? nsampreq * 4 : 0;
+  if (frame->snd_len > frame->snd_size)
+  {
+    frame->snd_size = frame->snd_len;
+    frame->snd = (unsigned char *) Z_Realloc (frame->snd, frame->snd_size);
+  }
+  if (frame->snd_len)
+    memcpy (frame->snd, snd, frame->snd_len);
+
+  frame->vid_len = vid || convert ? cap_frame_size : 0;
+  if (frame->vid_len > frame->vid_size)
+  {
+    frame->vid_size = frame->vid_len;
+    frame->vid = (unsigned char *) Z_Realloc (frame->vid, frame->vid_size);
+  }
+  if (vid && frame->vid_len)
+    memcpy (frame->vid, vid, frame->vid_len);
+
+  frame->convert = convert;
+  if (convert)
+  {
+    size_t raw_len = (size_t) SCREENWIDTH * SCREENHEIGHT;
+    int y;
+
+    if (raw_len > frame->raw_size)
+    {
+      frame->raw_size = raw_len;
+      frame->raw = (unsigned char *) Z_Realloc (frame->raw, frame->raw_size);
+    }
+    for (y = 0; y < SCREENHEIGHT; y++)
+      memcpy (frame->raw + y * SCREENWIDTH, screens[0].data + y * screens[0].pitch, SCREENWIDTH);
+    memcpy (frame->palette, I_GetScreenPalette (), sizeof (frame->palette));
+    frame->raw_width = SCREENWIDTH;
+    frame->raw_height = SCREENHEIGHT;
+  }
+  frame->vid_width = cap_width;
+  frame->vid_height = cap_height;
+
+  SDL_LockMutex (capmutex);
+  capframes_head = (capframes_head + 1) % capframes_count;
+  capframes_used++;
+  SDL_CondBroadcast (capcond);
+  SDL_UnlockMutex (capmutex);
 }
 
 
@@ -605,6 +1120,15 @@ void I_CaptureFinish (void)
     return;
   capturing_video = 0;
 
+  // flush frames still queued for the pipes
+  I_StopCaptureWriter ();
+
+  if (cap_libav)
+  {
+    I_AVCaptureClose ();
+    return;
+  }
+
   // on linux, we have to close videopipe first, because it has a copy of the write
   // end of soundpipe_stdin (so that stream will never see EOF).
   // is there a better way to do this?
@@ -628,8 +1152,8 @@ void I_CaptureFinish (void)
     return;
   }
 
-  muxpipe.stdoutdumpname = "mux_stdout.txt";
-  muxpipe.stderrdumpname = "mux_stderr.txt";
+  muxpipe.stdoutdumpname = I_SegmentDumpName ("mux_stdout.txt");
+  muxpipe.stderrdumpname = I_SegmentDumpName ("mux_stderr.txt");
   muxpipe.outthread = SDL_CreateThread (threadstdoutproc, "muxpipe.outthread", &muxpipe);
   muxpipe.errthread = SDL_CreateThread (threadstderrproc, "muxpipe.errthread", &muxpipe);
 
@@ -647,7 +1171,22 @@ void I_CaptureFinish (void)
     cap_tempfile1 = dsda_StringConfig(dsda_config_cap_tempfile1);
     cap_tempfile2 = dsda_StringConfig(dsda_config_cap_tempfile2);
 
-    M_remove (cap_tempfile1);
-    M_remove (cap_tempfile2);
+    if (cap_segment_suffix[0])
+    {
+      char *segment_tempfile;
+
+      segment_tempfile = I_SegmentFileName (cap_tempfile1);
+      M_remove (segment_tempfile);
+      Z_Free (segment_tempfile);
+
+      segment_tempfile = I_SegmentFileName (cap_tempfile2);
+      M_remove (segment_tempfile);
+      Z_Free (segment_tempfile);
+    }
+    else
+    {
+      M_remove (cap_tempfile1);
+      M_remove (cap_tempfile2);
+    }
   }
 }
@@ -49,4 +49,15 @@ void I_CaptureFrame (void);
 // close pipes, call muxcommand, finalize
 void I_CaptureFinish (void);
 
+// start a helper process, dumping its output to dumpname_stdout.txt / _stderr.txt
+// returns 0 on failure
+int I_CaptureStartProcess (const char *command, const char *dumpname);
+
+// wait for every helper process to exit
+// returns the number of processes that failed
+int I_CaptureWaitProcesses (void);
+
+// call concatcommand to join the files listed in listname into fn
+void I_CaptureConcat (const char *fn, const char *listname);
+
 #endif
@@ -52,6 +52,7 @@ extern const char *screen_resolutions_list[];
 extern const char *sdl_video_window_pos;
 
 void I_PreInitGraphics(void); /* CPhipps - do stuff immediately on start */
+dboolean I_Headless(void); /* software drawing without a window */
 void I_InitScreenResolution(void); /* init resolution */
 void I_SetWindowCaption(void); /* Set the window caption */
 void I_SetWindowIcon(void); /* Set the application icon */
@@ -72,6 +73,20 @@ int I_ScreenShot (const char *fname);
 // NSM expose lower level screen data grab for vidcap
 unsigned char *I_GrabScreen (void);
 
+typedef enum {
+  grab_format_rgb24,
+  grab_format_yuv420p,
+} grab_format_t;
+
+// software mode only: converts the 8-bit screen buffer directly,
+// at the internal render resolution (SCREENWIDTH x SCREENHEIGHT)
+// enlarged by a whole scale factor
+unsigned char *I_GrabScreenIndexed (grab_format_t format, int scale);
+int I_GrabScreenIndexedSize (grab_format_t format, int scale);
+void I_ConvertScreenIndexed (byte *dest, const byte *src, int pitch, int width, int height,
+                             int scale, const SDL_Color *colors, grab_format_t format);
+const SDL_Color *I_GetScreenPalette (void);
+
 /* I_StartTic
  * Called by D_DoomLoop,
  * called before processing each tic in a frame.
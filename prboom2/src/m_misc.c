@@ -157,6 +157,7 @@ cfg_def_t cfg_defs[] =
   MIGRATED_SETTING(dsda_config_integer_scaling),
   MIGRATED_SETTING(dsda_config_render_aspect),
   MIGRATED_SETTING(dsda_config_render_doom_lightmaps),
+  MIGRATED_SETTING(dsda_config_render_threads),
   MIGRATED_SETTING(dsda_config_fake_contrast_mode),
   MIGRATED_SETTING(dsda_config_render_stretch_hud),
   MIGRATED_SETTING(dsda_config_render_patches_scalex),
@@ -269,6 +270,9 @@ cfg_def_t cfg_defs[] =
   MIGRATED_SETTING(dsda_config_auto_key_frame_interval),
   MIGRATED_SETTING(dsda_config_auto_key_frame_depth),
   MIGRATED_SETTING(dsda_config_auto_key_frame_timeout),
+  MIGRATED_SETTING(dsda_config_auto_key_frame_full_interval),
+  MIGRATED_SETTING(dsda_config_demo_seek_index_interval),
+  MIGRATED_SETTING(dsda_config_brute_force_workers),
   MIGRATED_SETTING(dsda_config_exhud),
   MIGRATED_SETTING(dsda_config_ex_text_scale_x),
   MIGRATED_SETTING(dsda_config_ex_text_ratio_y),
@@ -320,11 +324,19 @@ cfg_def_t cfg_defs[] =
   MIGRATED_SETTING(dsda_config_cap_soundcommand),
   MIGRATED_SETTING(dsda_config_cap_videocommand),
   MIGRATED_SETTING(dsda_config_cap_muxcommand),
+  MIGRATED_SETTING(dsda_config_cap_concatcommand),
   MIGRATED_SETTING(dsda_config_cap_tempfile1),
   MIGRATED_SETTING(dsda_config_cap_tempfile2),
   MIGRATED_SETTING(dsda_config_cap_remove_tempfiles),
   MIGRATED_SETTING(dsda_config_cap_wipescreen),
   MIGRATED_SETTING(dsda_config_cap_fps),
+  MIGRATED_SETTING(dsda_config_cap_queue_frames),
+  MIGRATED_SETTING(dsda_config_cap_direct_format),
+  MIGRATED_SETTING(dsda_config_cap_direct_scale),
+  MIGRATED_SETTING(dsda_config_cap_builtin_encoder),
+  MIGRATED_SETTING(dsda_config_cap_video_codec),
+  MIGRATED_SETTING(dsda_config_cap_video_options),
+  MIGRATED_SETTING(dsda_config_cap_audio_codec),
 
   SETTING_HEADING("Overrun settings"),
   MIGRATED_SETTING(dsda_config_overrun_spechit_warn),
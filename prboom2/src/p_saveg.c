@@ -35,6 +35,7 @@
 
 #include "doomstat.h"
 #include "r_main.h"
+#include "r_bsp.h"
 #include "p_maputl.h"
 #include "p_spec.h"
 #include "p_tick.h"
@@ -259,6 +260,9 @@ void P_UnArchiveWorld (void)
   sector_t     *sec;
   line_t       *li;
 
+  // side textures are restored below
+  R_InvalidateBSPCache();
+
   for (i = 0, sec = sectors; i < numsectors; i++, sec++)
   {
     P_LOAD_X(sec->floorheight);
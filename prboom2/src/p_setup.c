@@ -41,6 +41,7 @@
 #include "w_wad.h"
 #include "r_main.h"
 #include "r_things.h"
+#include "r_bsp.h"
 #include "p_maputl.h"
 #include "p_map.h"
 #include "p_setup.h"
@@ -3806,6 +3807,7 @@ void P_SetupLevel(int episode, int map, int playermask, int skill)
   dsda_WatchBeforeLevelSetup();
 
   R_StopAllInterpolations();
+  R_InvalidateBSPCache();
 
   totallive = totalkills = totalitems = totalsecret = wminfo.maxfrags = 0;
   wminfo.partime = 180;
@@ -41,6 +41,9 @@
 #include "r_bsp.h" // cph - sanity checking
 #include "v_video.h"
 #include "lprintf.h"
+#include "e6y.h"
+
+#include "dsda/render_stats.h"
 
 // Turned off because it causes regressions on some maps (issue #256).  Fixing
 // this requires doing bleed with subsector granularity.
@@ -58,6 +61,9 @@
 
 int currentsubsectornum;
 
+static dboolean bsp_cache_recording;
+static void R_RecordBSPCacheSubsector(int num);
+
 seg_t     *curline;
 side_t    *sidedef;
 line_t    *linedef;
@@ -890,7 +896,126 @@ void R_RenderBSPNode(int bspnum)
       bspnum = bsp->children[side^1];
     }
   // e6y: support for extended nodes
-  R_Subsector(bspnum == -1 ? 0 : bspnum & ~NF_SUBSECTOR);
+  bspnum = bspnum == -1 ? 0 : bspnum & ~NF_SUBSECTOR;
+
+  if (bsp_cache_recording)
+    R_RecordBSPCacheSubsector(bspnum);
+
+  R_Subsector(bspnum);
+}
+
+//
+// BSP visibility cache
+//
+// Which subsectors R_RenderBSPNode reaches, and in what order, depends only
+// on the view and on which lines are solid. When neither has changed since
+// the last frame, the subsectors are drawn straight from the cached list,
+// skipping the node walk and its bounding box checks. Everything else
+// (segs, planes, sprites) is still set up from scratch, so moving things
+// and lighting changes are picked up as usual.
+//
+
+typedef struct
+{
+  fixed_t viewx, viewy, viewz;
+  angle_t viewangle, viewpitch;
+  angle_t clipangle;
+  int viewwidth, viewheight, centerx, centery;
+  unsigned int geometry;
+} bsp_cache_key_t;
+
+static bsp_cache_key_t bsp_cache_key;
+static dboolean bsp_cache_valid;
+static int *bsp_cache_subsectors;
+static int bsp_cache_count;
+static int bsp_cache_size;
+
+void R_InvalidateBSPCache(void)
+{
+  bsp_cache_valid = false;
+}
+
+// Everything that decides whether a line is closed, see R_RecalcLineFlags.
+// Side textures only change through specials that invalidate the cache.
+static unsigned int R_BSPGeometryHash(void)
+{
+  unsigned int hash = 2166136261u;
+  int i;
+
+  #define BSP_HASH(x) hash = (hash ^ (unsigned int) (x)) * 16777619u
+
+  for (i = 0; i < numsectors; i++)
+  {
+    BSP_HASH(sectors[i].floorheight);
+    BSP_HASH(sectors[i].ceilingheight);
+    BSP_HASH(sectors[i].ceilingpic);
+  }
+
+  for (i = 0; i < po_NumPolyobjs; i++)
+  {
+    BSP_HASH(polyobjs[i].startSpot.x);
+    BSP_HASH(polyobjs[i].startSpot.y);
+    BSP_HASH(polyobjs[i].angle);
+  }
+
+  #undef BSP_HASH
+
+  return hash;
+}
+
+static void R_RecordBSPCacheSubsector(int num)
+{
+  if (bsp_cache_count == bsp_cache_size)
+  {
+    bsp_cache_size = bsp_cache_size ? bsp_cache_size * 2 : 256;
+    bsp_cache_subsectors = Z_Realloc(bsp_cache_subsectors, bsp_cache_size * sizeof(*bsp_cache_subsectors));
+  }
+
+  bsp_cache_subsectors[bsp_cache_count++] = num;
+}
+
+void R_RenderBSPRoot(void)
+{
+  bsp_cache_key_t key;
+  int i;
+
+  // The OpenGL clipper has state of its own
+  if (!V_IsSoftwareMode())
+  {
+    R_RenderBSPNode(numnodes - 1);
+    return;
+  }
+
+  memset(&key, 0, sizeof(key));
+  key.viewx = viewx;
+  key.viewy = viewy;
+  key.viewz = viewz;
+  key.viewangle = viewangle;
+  key.viewpitch = viewpitch;
+  key.clipangle = clipangle;
+  key.viewwidth = viewwidth;
+  key.viewheight = viewheight;
+  key.centerx = centerx;
+  key.centery = centery;
+  key.geometry = R_BSPGeometryHash();
+
+  if (bsp_cache_valid && !memcmp(&key, &bsp_cache_key, sizeof(key)))
+  {
+    dsda_RecordBSPCacheHit();
+
+    for (i = 0; i < bsp_cache_count; i++)
+      R_Subsector(bsp_cache_subsectors[i]);
+
+    return;
+  }
+
+  bsp_cache_count = 0;
+  bsp_cache_recording = true;
+  R_RenderBSPNode(numnodes - 1);
+  bsp_cache_recording = false;
+
+  bsp_cache_key = key;
+  bsp_cache_valid = true;
 }
 
 void R_ForceRenderPolyObjs(void)
@@ -54,6 +54,8 @@ extern drawseg_t *ds_p;
 void R_ClearClipSegs(void);
 void R_ClearDrawSegs(void);
 void R_RenderBSPNode(int bspnum);
+void R_RenderBSPRoot(void);
+void R_InvalidateBSPCache(void);
 void R_ForceRenderPolyObjs(void);
 
 /* killough 4/13/98: fake floors/ceilings for deep water / fake ceilings: */
@@ -34,6 +34,15 @@
  *-----------------------------------------------------------------------------*/
 
 #include <stdint.h>
+#include <string.h>
+
+// The AVX2 span drawer is compiled with a per-function target attribute
+// and only used when the CPU reports support at runtime
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 5))
+#define R_DRAWSPAN_AVX2
+#include <immintrin.h>
+#endif
 
 #include "doomstat.h"
 #include "w_wad.h"
@@ -85,8 +94,16 @@ typedef enum
    COL_FLEXADD
 } columntype_e;
 
+// Number of adjacent columns batched in tempbuf before they are flushed.
+// Full batches are written a whole row at a time, so this should be a
+// power of two no wider than the vector registers (8 or 16).
+#ifndef TEMP_COLUMNS_SHIFT
+#define TEMP_COLUMNS_SHIFT 4
+#endif
+#define TEMP_COLUMNS (1 << TEMP_COLUMNS_SHIFT)
+
 static int    temp_x = 0;
-static int    tempyl[4], tempyh[4];
+static int    tempyl[TEMP_COLUMNS], tempyh[TEMP_COLUMNS];
 
 // e6y: resolution limitation is removed
 static byte           *tempbuf;
@@ -175,7 +192,7 @@ static void (*R_FlushQuadColumn)(void) = R_QuadFlushError;
 
 static void R_FlushColumns(void)
 {
-   if(temp_x != 4 || commontop >= commonbot)
+   if(temp_x != TEMP_COLUMNS || commontop >= commonbot)
       R_FlushWholeColumns();
    else
    {
@@ -431,7 +448,7 @@ void R_InitTranslationTables (void)
 //  and the inner loop has to step in texture space u and v.
 //
 
-void R_DrawSpan(draw_span_vars_t *dsvars) {
+static void R_DrawSpanScalar(draw_span_vars_t *dsvars) {
   unsigned count = dsvars->x2 - dsvars->x1 + 1;
   fixed_t xfrac = dsvars->xfrac;
   fixed_t yfrac = dsvars->yfrac;
@@ -452,6 +469,101 @@ void R_DrawSpan(draw_span_vars_t *dsvars) {
   }
 }
 
+#ifdef R_DRAWSPAN_AVX2
+
+// Eight pixels per iteration, both lookups done with gathers.
+// A gather reads 4 bytes, so each one reads the 3 bytes before the texel
+// and keeps the top byte. Flats and colormaps are lumps or zone blocks,
+// which always have a header in front, while reading past the end of a
+// lump could run off the end of a mapped wad.
+
+__attribute__((target("avx2")))
+static void R_DrawSpanAVX2(draw_span_vars_t *dsvars) {
+  unsigned count = dsvars->x2 - dsvars->x1 + 1;
+  fixed_t xfrac = dsvars->xfrac;
+  fixed_t yfrac = dsvars->yfrac;
+  const fixed_t xstep = dsvars->xstep;
+  const fixed_t ystep = dsvars->ystep;
+  byte *dest = drawvars.topleft + dsvars->y*drawvars.pitch + dsvars->x1;
+
+  if (count >= 8) {
+    const int *source = (const int *) (dsvars->source - 3);
+    const int *colormap = (const int *) (dsvars->colormap - 3);
+    const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256i xstep8 = _mm256_set1_epi32(xstep * 8);
+    const __m256i ystep8 = _mm256_set1_epi32(ystep * 8);
+    const __m256i xmask = _mm256_set1_epi32(63);
+    const __m256i ymask = _mm256_set1_epi32(4032);
+    __m256i vxfrac = _mm256_add_epi32(_mm256_set1_epi32(xfrac),
+                                      _mm256_mullo_epi32(lanes, _mm256_set1_epi32(xstep)));
+    __m256i vyfrac = _mm256_add_epi32(_mm256_set1_epi32(yfrac),
+                                      _mm256_mullo_epi32(lanes, _mm256_set1_epi32(ystep)));
+
+    do {
+      __m256i spot, texel, pixel;
+      uint32_t lo, hi;
+
+      spot = _mm256_or_si256(_mm256_and_si256(_mm256_srai_epi32(vxfrac, 16), xmask),
+                             _mm256_and_si256(_mm256_srai_epi32(vyfrac, 10), ymask));
+      texel = _mm256_srli_epi32(_mm256_i32gather_epi32(source, spot, 1), 24);
+      pixel = _mm256_srli_epi32(_mm256_i32gather_epi32(colormap, texel, 1), 24);
+
+      // packs within each 128 bit half, so pixels 0-3 and 4-7 end up
+      // in the low dword of each half
+      pixel = _mm256_packus_epi32(pixel, pixel);
+      pixel = _mm256_packus_epi16(pixel, pixel);
+      lo = _mm256_extract_epi32(pixel, 0);
+      hi = _mm256_extract_epi32(pixel, 4);
+      memcpy(dest, &lo, 4);
+      memcpy(dest + 4, &hi, 4);
+
+      vxfrac = _mm256_add_epi32(vxfrac, xstep8);
+      vyfrac = _mm256_add_epi32(vyfrac, ystep8);
+      xfrac += xstep * 8;
+      yfrac += ystep * 8;
+      dest += 8;
+      count -= 8;
+    } while (count >= 8);
+  }
+
+  {
+    const byte *source = dsvars->source;
+    const byte *colormap = dsvars->colormap;
+
+    while (count) {
+      const fixed_t xtemp = (xfrac >> 16) & 63;
+      const fixed_t ytemp = (yfrac >> 10) & 4032;
+      const fixed_t spot = xtemp | ytemp;
+      xfrac += xstep;
+      yfrac += ystep;
+      *dest++ = colormap[source[spot]];
+      count--;
+    }
+  }
+}
+
+#endif
+
+static void (*R_DrawSpanFunc)(draw_span_vars_t *dsvars) = R_DrawSpanScalar;
+
+// Picks the fastest span drawer the CPU supports.
+// All of them produce the same pixels.
+
+static void R_InitDrawSpan(void)
+{
+  R_DrawSpanFunc = R_DrawSpanScalar;
+
+#ifdef R_DRAWSPAN_AVX2
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2"))
+    R_DrawSpanFunc = R_DrawSpanAVX2;
+#endif
+}
+
+void R_DrawSpan(draw_span_vars_t *dsvars) {
+  R_DrawSpanFunc(dsvars);
+}
+
 void R_InitBuffersRes(void)
 {
   extern byte *solidcol;
@@ -460,7 +572,7 @@ void R_InitBuffersRes(void)
   if (tempbuf) Z_Free(tempbuf);
 
   solidcol = Z_Calloc(1, SCREENWIDTH * sizeof(*solidcol));
-  tempbuf = Z_Calloc(1, (SCREENHEIGHT * 4) * sizeof(*tempbuf));
+  tempbuf = Z_Calloc(1, (SCREENHEIGHT * TEMP_COLUMNS) * sizeof(*tempbuf));
 
   temp_x = 0;
 }
@@ -480,6 +592,8 @@ void R_InitBuffer(int width, int height)
   drawvars.topleft = screens[0].data;
   drawvars.pitch = screens[0].pitch;
 
+  R_InitDrawSpan();
+
   for (i=0; i<FUZZTABLE; i++)
     fuzzoffset[i] = fuzzoffset_org[i]*screens[0].pitch;
 }
@@ -104,7 +104,7 @@ static void R_DRAWCOLUMN_FUNCNAME(draw_column_vars_t *dcvars)
    // SoM: MAGIC
    {
       // haleyjd: reordered predicates
-      if(temp_x == 4 ||
+      if(temp_x == TEMP_COLUMNS ||
          (temp_x && (temptype != COLTYPE || temp_x + startx != dcvars->x)))
          R_FlushColumns();
 
@@ -123,7 +123,7 @@ static void R_DRAWCOLUMN_FUNCNAME(draw_column_vars_t *dcvars)
          R_FlushHTColumns    = R_FLUSHHEADTAIL_FUNCNAME;
          R_FlushQuadColumn   = R_FLUSHQUAD_FUNCNAME;
 #if (!(R_DRAWCOLUMN_PIPELINE & RDC_FUZZ))
-         dest = &tempbuf[dcvars->yl << 2];
+         dest = &tempbuf[dcvars->yl << TEMP_COLUMNS_SHIFT];
 #endif
       } else {
          tempyl[temp_x] = dcvars->yl;
@@ -134,7 +134,7 @@ static void R_DRAWCOLUMN_FUNCNAME(draw_column_vars_t *dcvars)
          if(dcvars->yh < commonbot)
             commonbot = dcvars->yh;
 #if (!(R_DRAWCOLUMN_PIPELINE & RDC_FUZZ))
-         dest = &tempbuf[(dcvars->yl << 2) + temp_x];
+         dest = &tempbuf[(dcvars->yl << TEMP_COLUMNS_SHIFT) + temp_x];
 #endif
       }
       temp_x += 1;
@@ -165,14 +165,14 @@ static void R_DRAWCOLUMN_FUNCNAME(draw_column_vars_t *dcvars)
       #define FIXEDT_128MASK ((127<<FRACBITS)|0xffff)
       while(count--) {
         *dest = GETCOL(frac & FIXEDT_128MASK);
-        dest += 4;
+        dest += TEMP_COLUMNS;
         frac += fracstep;
       }
     } else if (dcvars->texheight == 0) {
       /* cph - another special case */
       while (count--) {
         *dest = GETCOL(frac);
-        dest += 4;
+        dest += TEMP_COLUMNS;
         frac += fracstep;
       }
     } else {
@@ -181,10 +181,10 @@ static void R_DRAWCOLUMN_FUNCNAME(draw_column_vars_t *dcvars)
         fixed_t fixedt_heightmask = (heightmask<<FRACBITS)|0xffff;
         while ((count-=2)>=0) { // texture height is a power of 2 -- killough
           *dest = GETCOL(frac & fixedt_heightmask);
-          dest += 4;
+          dest += TEMP_COLUMNS;
           frac += fracstep;
           *dest = GETCOL(frac & fixedt_heightmask);
-          dest += 4;
+          dest += TEMP_COLUMNS;
           frac += fracstep;
         }
         if (count & 1)
@@ -206,7 +206,7 @@ static void R_DRAWCOLUMN_FUNCNAME(draw_column_vars_t *dcvars)
           // heightmask is the Tutti-Frutti fix -- killough
 
           *dest = GETCOL(frac);
-          dest += 4;
+          dest += TEMP_COLUMNS;
           if ((frac += fracstep) >= (int)heightmask)
             frac -= heightmask;
         }
@@ -52,7 +52,7 @@ static void R_FLUSHWHOLE_FUNCNAME(void)
    while(--temp_x >= 0)
    {
       yl     = tempyl[temp_x];
-      source = &tempbuf[temp_x + (yl << 2)];
+      source = &tempbuf[temp_x + (yl << TEMP_COLUMNS_SHIFT)];
       dest   = drawvars.topleft + yl*drawvars.pitch + startx + temp_x;
       count  = tempyh[temp_x] - yl + 1;
 
@@ -71,7 +71,7 @@ static void R_FLUSHWHOLE_FUNCNAME(void)
          *dest = *source;
 #endif
 
-         source += 4;
+         source += TEMP_COLUMNS;
          dest += drawvars.pitch;
       }
    }
@@ -91,7 +91,7 @@ static void R_FLUSHHEADTAIL_FUNCNAME(void)
    int count, colnum = 0;
    int yl, yh;
 
-   while(colnum < 4)
+   while(colnum < TEMP_COLUMNS)
    {
       yl = tempyl[colnum];
       yh = tempyh[colnum];
@@ -99,7 +99,7 @@ static void R_FLUSHHEADTAIL_FUNCNAME(void)
       // flush column head
       if(yl < commontop)
       {
-         source = &tempbuf[colnum + (yl << 2)];
+         source = &tempbuf[colnum + (yl << TEMP_COLUMNS_SHIFT)];
          dest   = drawvars.topleft + yl*drawvars.pitch + startx + colnum;
          count  = commontop - yl;
 
@@ -119,7 +119,7 @@ static void R_FLUSHHEADTAIL_FUNCNAME(void)
             *dest = *source;
 #endif
 
-            source += 4;
+            source += TEMP_COLUMNS;
             dest += drawvars.pitch;
          }
       }
@@ -127,7 +127,7 @@ static void R_FLUSHHEADTAIL_FUNCNAME(void)
       // flush column tail
       if(yh > commonbot)
       {
-         source = &tempbuf[colnum + ((commonbot + 1) << 2)];
+         source = &tempbuf[colnum + ((commonbot + 1) << TEMP_COLUMNS_SHIFT)];
          dest   = drawvars.topleft + (commonbot + 1)*drawvars.pitch + startx + colnum;
          count  = yh - commonbot;
 
@@ -147,7 +147,7 @@ static void R_FLUSHHEADTAIL_FUNCNAME(void)
             *dest = *source;
 #endif
 
-            source += 4;
+            source += TEMP_COLUMNS;
             dest += drawvars.pitch;
          }
       }
@@ -155,18 +155,23 @@ static void R_FLUSHHEADTAIL_FUNCNAME(void)
    }
 }
 
+// Flushes the rows shared by all columns of a full batch.
+// Loops run over a constant TEMP_COLUMNS, so the compiler unrolls them
+// and the opaque copy becomes a single TEMP_COLUMNS byte move per row.
 static void R_FLUSHQUAD_FUNCNAME(void)
 {
-   byte *source = &tempbuf[commontop << 2];
+   byte *source = &tempbuf[commontop << TEMP_COLUMNS_SHIFT];
    byte *dest = drawvars.topleft + commontop*drawvars.pitch + startx;
    int count;
+#if (R_DRAWCOLUMN_PIPELINE & (RDC_TRANSLUCENT | RDC_FUZZ))
+   int i;
+#endif
 #if (R_DRAWCOLUMN_PIPELINE & RDC_FUZZ)
-   int fuzz1, fuzz2, fuzz3, fuzz4;
+   int fuzz[TEMP_COLUMNS];
 
-   fuzz1 = fuzzpos;
-   fuzz2 = (fuzz1 + tempyl[1]) % FUZZTABLE;
-   fuzz3 = (fuzz2 + tempyl[2]) % FUZZTABLE;
-   fuzz4 = (fuzz3 + tempyl[3]) % FUZZTABLE;
+   fuzz[0] = fuzzpos;
+   for (i = 1; i < TEMP_COLUMNS; i++)
+      fuzz[i] = (fuzz[i - 1] + tempyl[i]) % FUZZTABLE;
 #endif
 
    count = commonbot - commontop + 1;
@@ -174,45 +179,28 @@ static void R_FLUSHQUAD_FUNCNAME(void)
 #if (R_DRAWCOLUMN_PIPELINE & RDC_TRANSLUCENT)
    while(--count >= 0)
    {
-      dest[0] = GETDESTCOLOR(dest[0], source[0]);
-      dest[1] = GETDESTCOLOR(dest[1], source[1]);
-      dest[2] = GETDESTCOLOR(dest[2], source[2]);
-      dest[3] = GETDESTCOLOR(dest[3], source[3]);
-      source += 4 * sizeof(byte);
+      for (i = 0; i < TEMP_COLUMNS; i++)
+         dest[i] = GETDESTCOLOR(dest[i], source[i]);
+      source += TEMP_COLUMNS * sizeof(byte);
       dest += drawvars.pitch * sizeof(byte);
    }
 #elif (R_DRAWCOLUMN_PIPELINE & RDC_FUZZ)
    while(--count >= 0)
    {
-      dest[0] = GETDESTCOLOR(dest[0 + fuzzoffset[fuzz1]]);
-      dest[1] = GETDESTCOLOR(dest[1 + fuzzoffset[fuzz2]]);
-      dest[2] = GETDESTCOLOR(dest[2 + fuzzoffset[fuzz3]]);
-      dest[3] = GETDESTCOLOR(dest[3 + fuzzoffset[fuzz4]]);
-      fuzz1 = (fuzz1 + 1) % FUZZTABLE;
-      fuzz2 = (fuzz2 + 1) % FUZZTABLE;
-      fuzz3 = (fuzz3 + 1) % FUZZTABLE;
-      fuzz4 = (fuzz4 + 1) % FUZZTABLE;
-      source += 4 * sizeof(byte);
+      for (i = 0; i < TEMP_COLUMNS; i++)
+      {
+         dest[i] = GETDESTCOLOR(dest[i + fuzzoffset[fuzz[i]]]);
+         fuzz[i] = (fuzz[i] + 1) % FUZZTABLE;
+      }
+      source += TEMP_COLUMNS * sizeof(byte);
       dest += drawvars.pitch * sizeof(byte);
    }
 #else
-   if ((sizeof(int) == 4) && (((intptr_t)source % 4) == 0) && (((intptr_t)dest % 4) == 0)) {
-      while(--count >= 0)
-      {
-         *(int *)dest = *(int *)source;
-         source += 4 * sizeof(byte);
-         dest += drawvars.pitch * sizeof(byte);
-      }
-   } else {
-      while(--count >= 0)
-      {
-         dest[0] = source[0];
-         dest[1] = source[1];
-         dest[2] = source[2];
-         dest[3] = source[3];
-         source += 4 * sizeof(byte);
-         dest += drawvars.pitch * sizeof(byte);
-      }
+   while(--count >= 0)
+   {
+      memcpy(dest, source, TEMP_COLUMNS);
+      source += TEMP_COLUMNS * sizeof(byte);
+      dest += drawvars.pitch * sizeof(byte);
    }
 #endif
 }
@@ -33,6 +33,7 @@
  */
 
 #include "doomstat.h"
+#include "cman.h"
 #include "m_random.h"
 #include "r_defs.h"
 #include "r_state.h"
@@ -155,6 +156,8 @@ void R_InterpolateView(player_t *player, fixed_t frac)
       viewangle = player->prev_viewangle + FixedMul (frac, R_SmoothPlaying_Get(player) - player->prev_viewangle);
       viewpitch = player->prev_viewpitch + FixedMul (frac, P_PlayerPitch(player) - player->prev_viewpitch);
     }
+
+    CMAN_InterpolateView(frac);
   }
   else
   {
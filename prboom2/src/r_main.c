@@ -94,6 +94,9 @@ int      centerx, centery;
 // e6y: wide-res
 int wide_centerx;
 
+unsigned int lightscale_mul;
+fixed_t lightscale_bounds[MAXLIGHTSCALE];
+
 fixed_t  focallength;
 fixed_t  focallengthy;
 fixed_t  globaluclip, globaldclip;
@@ -748,6 +751,16 @@ void R_ExecuteSetViewSize (void)
     }
   }
 
+  // Scale to light index lookup for walls and sprites:
+  // lightscale_bounds[j] is the smallest scale with index j
+  lightscale_mul = (unsigned int) ((160ull << (32 - LIGHTSCALESHIFT)) / MAX(wide_centerx, 1));
+  for (i = 0; i < MAXLIGHTSCALE; i++)
+  {
+    int64_t bound = ((int64_t) i * wide_centerx << LIGHTSCALESHIFT) + 159;
+
+    lightscale_bounds[i] = (fixed_t) MIN(bound / 160, INT_MAX);
+  }
+
   if (V_IsOpenGLMode())
     dsda_GLSetRenderViewportParams();
 
@@ -977,13 +990,12 @@ static void R_RenderBSPNodes(void)
   if (localQuakeHappening[displayplayer] && gamestate == GS_LEVEL)
   {
     players[displayplayer].mo->flags2 |= MF2_DONTDRAW;
-    R_RenderBSPNode(numnodes - 1);  // head node is the last node output
+    R_RenderBSPRoot();
     players[displayplayer].mo->flags2 &= ~MF2_DONTDRAW;
   }
   else
   {
-    // The head node is the last node output.
-    R_RenderBSPNode(numnodes - 1);
+    R_RenderBSPRoot();
   }
 
   if (map_format.zdoom && V_IsOpenGLMode())
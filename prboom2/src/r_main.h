@@ -94,6 +94,28 @@ extern int LIGHTLEVELS;
 #define MAXLIGHTZ        128
 #define LIGHTZSHIFT       20
 
+// Precomputed per view size by R_ExecuteSetViewSize
+extern unsigned int lightscale_mul;
+extern fixed_t lightscale_bounds[MAXLIGHTSCALE];
+
+// Same as ((int64_t) scale * 160 / wide_centerx) >> LIGHTSCALESHIFT clamped
+// to MAXLIGHTSCALE - 1, without the 64-bit division. The multiply undershoots
+// by at most one, which the bounds table corrects.
+inline static int R_LightScaleIndex(fixed_t scale)
+{
+  int index;
+
+  if (scale <= 0)
+    return 0;
+
+  index = (int) (((uint64_t) scale * lightscale_mul) >> 32);
+
+  if (index >= MAXLIGHTSCALE - 1)
+    return MAXLIGHTSCALE - 1;
+
+  return index + (scale >= lightscale_bounds[index + 1]);
+}
+
 // killough 3/20/98: Allow colormaps to be dynamic (e.g. underwater)
 extern const lighttable_t *(*scalelight)[MAXLIGHTSCALE];
 extern const lighttable_t *(*c_zlight)[LIGHTLEVELS_MAX][MAXLIGHTZ];
@@ -31,10 +31,9 @@
  *       while maintaining a per column clipping list only.
  *      Moreover, the sky areas have to be determined.
  *
- * MAXVISPLANES is no longer a limit on the number of visplanes,
- * but a limit on the number of hash slots; larger numbers mean
- * better performance usually but after a point they are wasted,
- * and memory and time overheads creep in.
+ * Visplanes are found through an open-addressed hash table that grows
+ * with the most visplanes seen in a frame, so lookups stay short on
+ * detailed maps.
  *
  * For more information on visplanes, see:
  *
@@ -60,6 +59,7 @@
 #include "r_main.h"
 #include "v_video.h"
 #include "lprintf.h"
+#include "r_threads.h"
 
 #include "dsda/map_format.h"
 #include "dsda/render_stats.h"
@@ -70,18 +70,80 @@ fixed_t Sky1ColumnOffset;
 fixed_t Sky2ColumnOffset;
 dboolean DoubleSky;
 
-#define MAXVISPLANES 256    /* must be a power of 2 */
+// Every visplane allocated so far; the first num_visplanes are in use
+// this frame, in the order they were created, and the rest are free
+static visplane_t **visplanes;
+static int num_visplanes;
+static int num_allocated_visplanes;
+static int max_visplanes;
+
+// Open-addressed table holding the newest visplane for each key, since
+// R_DupPlane makes planes with the same key as an existing one.
+// Kept at most half full, the size is a power of 2.
+static visplane_t **visplane_table;
+static unsigned visplane_table_size;
 
-static visplane_t *visplanes[MAXVISPLANES];   // killough
-static visplane_t *freetail;                  // killough
-static visplane_t **freehead = &freetail;     // killough
 visplane_t *floorplane, *ceilingplane;
 
-// killough -- hash function for visplanes
-// Empirically verified to be fairly uniform:
+static unsigned R_VisplaneHash(fixed_t height, int picnum, int lightlevel,
+                               fixed_t xoffs, fixed_t yoffs)
+{
+  unsigned hash;
+
+  hash = (unsigned)picnum * 0x9e3779b1u;
+  hash = (hash ^ (unsigned)lightlevel) * 0x85ebca6bu;
+  hash = (hash ^ (unsigned)height) * 0xc2b2ae35u;
+  hash = (hash ^ (unsigned)xoffs) * 0x27d4eb2fu;
+  hash = (hash ^ (unsigned)yoffs) * 0x165667b1u;
+
+  return hash ^ (hash >> 16);
+}
+
+#define R_PlaneHash(pl) \
+  R_VisplaneHash((pl)->height, (pl)->picnum, (pl)->lightlevel, (pl)->xoffs, (pl)->yoffs)
+
+static dboolean R_SamePlane(const visplane_t *pl, fixed_t height, int picnum, int lightlevel,
+                            int special, fixed_t xoffs, fixed_t yoffs, angle_t rotation,
+                            fixed_t xscale, fixed_t yscale)
+{
+  return height == pl->height &&
+         picnum == pl->picnum &&
+         lightlevel == pl->lightlevel &&
+         special == pl->special &&
+         xoffs == pl->xoffs &&      // killough 2/28/98: Add offset checks
+         yoffs == pl->yoffs &&
+         rotation == pl->rotation &&
+         xscale == pl->xscale &&
+         yscale == pl->yscale;
+}
+
+// Makes pl the one found for its key, replacing an older plane with the same key
+static void R_InsertPlane(visplane_t *pl)
+{
+  unsigned mask = visplane_table_size - 1;
+  unsigned i = R_PlaneHash(pl) & mask;
+  visplane_t *check;
+
+  for (; (check = visplane_table[i]); i = (i + 1) & mask)
+    if (R_SamePlane(check, pl->height, pl->picnum, pl->lightlevel, pl->special,
+                    pl->xoffs, pl->yoffs, pl->rotation, pl->xscale, pl->yscale))
+      break;
+
+  visplane_table[i] = pl;
+}
+
+static void R_ResizePlaneTable(unsigned size)
+{
+  int i;
+
+  Z_Free(visplane_table);
+  visplane_table = Z_Calloc(size, sizeof(*visplane_table));
+  visplane_table_size = size;
 
-#define visplane_hash(picnum,lightlevel,height) \
-  ((unsigned)((picnum)*3+(lightlevel)+(height)*7) & (MAXVISPLANES-1))
+  // Planes in creation order, so the newest of each key wins
+  for (i = 0; i < num_visplanes; i++)
+    R_InsertPlane(visplanes[i]);
+}
 
 size_t maxopenings;
 int *openings,*lastopening; // dropoff overflow
@@ -137,13 +199,17 @@ void R_InitVisplanesRes(void)
 {
   int i;
 
-  freetail = NULL;
-  freehead = &freetail;
+  // Visplane size depends on the screen width
+  for (i = 0; i < num_allocated_visplanes; i++)
+    Z_Free(visplanes[i]);
 
-  for (i = 0; i < MAXVISPLANES; i++)
-  {
-    visplanes[i] = 0;
-  }
+  num_visplanes = 0;
+  num_allocated_visplanes = 0;
+
+  if (!visplane_table)
+    R_ResizePlaneTable(512);
+  else
+    memset(visplane_table, 0, visplane_table_size * sizeof(*visplane_table));
 }
 
 //
@@ -230,9 +296,19 @@ void R_ClearPlanes(void)
   for (i=0 ; i<viewwidth ; i++)
     floorclip[i] = viewheight, ceilingclip[i] = -1;
 
-  for (i=0;i<MAXVISPLANES;i++)    // new code -- killough
-    for (*freehead = visplanes[i], visplanes[i] = NULL; *freehead; )
-      freehead = &(*freehead)->next;
+  // Start the frame with room for the busiest frame so far
+  num_visplanes = 0;
+  if (!visplane_table || visplane_table_size < (unsigned) max_visplanes * 2)
+  {
+    unsigned size = MAX(visplane_table_size, 512);
+
+    while (size < (unsigned) max_visplanes * 2)
+      size <<= 1;
+
+    R_ResizePlaneTable(size);
+  }
+  else
+    memset(visplane_table, 0, visplane_table_size * sizeof(*visplane_table));
 
   lastopening = openings;
 
@@ -242,23 +318,43 @@ void R_ClearPlanes(void)
 
 // New function, by Lee Killough
 
-static visplane_t *new_visplane(unsigned hash)
+// The caller fills in the key, then adds the plane with R_InsertPlane
+static visplane_t *new_visplane(void)
 {
-  visplane_t *check = freetail;
-  if (!check)
+  visplane_t *check;
+
+  if (num_visplanes == num_allocated_visplanes)
   {
+    if (num_allocated_visplanes == max_visplanes)
+    {
+      max_visplanes = max_visplanes ? max_visplanes * 2 : 128;
+      visplanes = Z_Realloc(visplanes, max_visplanes * sizeof(*visplanes));
+    }
+
     // e6y: resolution limitation is removed
     check = Z_Calloc(1, sizeof(*check) + sizeof(*check->top) * (SCREENWIDTH * 2));
     check->bottom = &check->top[SCREENWIDTH + 2];
+    visplanes[num_allocated_visplanes++] = check;
   }
-  else
-    if (!(freetail = freetail->next))
-      freehead = &freetail;
-  check->next = visplanes[hash];
-  visplanes[hash] = check;
+
+  check = visplanes[num_visplanes++];
+
+  if ((unsigned) num_visplanes * 2 > visplane_table_size)
+    R_ResizePlaneTable(visplane_table_size * 2);
+
   return check;
 }
 
+// Top is only kept valid inside minx..maxx, columns entering the range
+// are cleared as it grows
+static void R_ClearPlaneColumns(visplane_t *pl, int start, int stop)
+{
+  int i;
+
+  for (i = start; i <= stop; i++)
+    pl->top[i] = SHRT_MAX;
+}
+
 /*
  * R_DupPlane
  *
@@ -266,9 +362,7 @@ static visplane_t *new_visplane(unsigned hash)
  */
 visplane_t *R_DupPlane(const visplane_t *pl, int start, int stop)
 {
-      int i;
-      unsigned hash = visplane_hash(pl->picnum, pl->lightlevel, pl->height);
-      visplane_t *new_pl = new_visplane(hash);
+      visplane_t *new_pl = new_visplane();
 
       new_pl->height = pl->height;
       new_pl->picnum = pl->picnum;
@@ -281,8 +375,8 @@ visplane_t *R_DupPlane(const visplane_t *pl, int start, int stop)
       new_pl->yscale = pl->yscale;
       new_pl->minx = start;
       new_pl->maxx = stop;
-      for (i = 0; i != SCREENWIDTH; i++)
-        new_pl->top[i] = SHRT_MAX;
+      R_ClearPlaneColumns(new_pl, start, stop);
+      R_InsertPlane(new_pl);
       return new_pl;
 }
 //
@@ -294,7 +388,7 @@ visplane_t *R_FindPlane(fixed_t height, int picnum, int lightlevel, int special,
                         fixed_t xoffs, fixed_t yoffs, angle_t rotation, fixed_t xscale, fixed_t yscale)
 {
   visplane_t *check;
-  unsigned hash;                      // killough
+  unsigned hash, mask;
 
   if (map_format.hexen && special < 150)
   {
@@ -304,22 +398,15 @@ visplane_t *R_FindPlane(fixed_t height, int picnum, int lightlevel, int special,
   if (picnum == skyflatnum || picnum & PL_SKYFLAT)
     height = lightlevel = 0;         // killough 7/19/98: most skies map together
 
-  // New visplane algorithm uses hash table -- killough
-  hash = visplane_hash(picnum,lightlevel,height);
-
-  for (check=visplanes[hash]; check; check=check->next)  // killough
-    if (height == check->height &&
-        picnum == check->picnum &&
-        lightlevel == check->lightlevel &&
-        special == check->special &&
-        xoffs == check->xoffs &&      // killough 2/28/98: Add offset checks
-        yoffs == check->yoffs &&
-        rotation == check->rotation &&
-        xscale == check->xscale &&
-        yscale == check->yscale)
+  mask = visplane_table_size - 1;
+  hash = R_VisplaneHash(height, picnum, lightlevel, xoffs, yoffs) & mask;
+
+  for (; (check = visplane_table[hash]); hash = (hash + 1) & mask)
+    if (R_SamePlane(check, height, picnum, lightlevel, special,
+                    xoffs, yoffs, rotation, xscale, yscale))
       return check;
 
-  check = new_visplane(hash);         // killough
+  check = new_visplane();
 
   check->height = height;
   check->picnum = picnum;
@@ -333,14 +420,12 @@ visplane_t *R_FindPlane(fixed_t height, int picnum, int lightlevel, int special,
 
   if (V_IsSoftwareMode())
   {
-    int i;
     check->minx = viewwidth; // Was SCREENWIDTH -- killough 11/98
     check->maxx = -1;
-
-    for (i = 0; i != SCREENWIDTH; i++)
-      check->top[i] = SHRT_MAX;
   }
 
+  R_InsertPlane(check);
+
   return check;
 }
 
@@ -365,6 +450,13 @@ visplane_t *R_CheckPlane(visplane_t *pl, int start, int stop)
     ;
 
   if (x > intrh) { /* Can use existing plane; extend range */
+    if (pl->minx > pl->maxx)
+      R_ClearPlaneColumns(pl, unionl, unionh);
+    else
+    {
+      R_ClearPlaneColumns(pl, unionl, pl->minx - 1);
+      R_ClearPlaneColumns(pl, pl->maxx + 1, unionh);
+    }
     pl->minx = unionl; pl->maxx = unionh;
     return pl;
   } else /* Cannot use existing plane; create a new one */
@@ -409,6 +501,181 @@ const rpatch_t *R_HackedSkyPatch(texture_t *texture)
   return NULL;
 }
 
+// Everything about a flat that does not depend on the screen row
+
+static void R_SetupFlatPlane(visplane_t *pl, draw_span_vars_t *dsvars)
+{
+  int light;
+
+  dsvars->source = W_LumpByNum(firstflat + flattranslation[pl->picnum]);
+  dsvars->xoffs = pl->xoffs;
+  dsvars->yoffs = pl->yoffs;
+  dsvars->xscale = pl->xscale;
+  dsvars->yscale = pl->yscale;
+
+  if (pl->rotation)
+  {
+    fixed_t rotation_cos, rotation_sin;
+
+    rotation_cos = finecosine[pl->rotation >> ANGLETOFINESHIFT];
+    rotation_sin = finesine[pl->rotation >> ANGLETOFINESHIFT];
+
+    dsvars->xoffs += FixedMul(rotation_cos, viewx) - FixedMul(rotation_sin, viewy);
+    dsvars->yoffs -= FixedMul(rotation_sin, viewx) + FixedMul(rotation_cos, viewy);
+    dsvars->sine = finesine[(viewangle + pl->rotation) >> ANGLETOFINESHIFT];
+    dsvars->cosine = finecosine[(viewangle + pl->rotation) >> ANGLETOFINESHIFT];
+  }
+  else
+  {
+    dsvars->xoffs += viewx;
+    dsvars->yoffs -= viewy;
+    dsvars->sine = viewsin;
+    dsvars->cosine = viewcos;
+  }
+
+  if (map_format.hexen)
+  {
+    int scrollOffset = leveltime >> 1 & 63;
+
+    switch (pl->special)
+    {                       // Handle scrolling flats
+      case 201:
+      case 202:
+      case 203:          // Scroll_North_xxx
+        dsvars->source = dsvars->source + ((scrollOffset
+                                   << (pl->special - 201) & 63) << 6);
+        break;
+      case 204:
+      case 205:
+      case 206:          // Scroll_East_xxx
+        dsvars->source = dsvars->source + ((63 - scrollOffset)
+                                  << (pl->special - 204) & 63);
+        break;
+      case 207:
+      case 208:
+      case 209:          // Scroll_South_xxx
+        dsvars->source = dsvars->source + (((63 - scrollOffset)
+                                   << (pl->special - 207) & 63) << 6);
+        break;
+      case 210:
+      case 211:
+      case 212:          // Scroll_West_xxx
+        dsvars->source = dsvars->source + (scrollOffset
+                                  << (pl->special - 210) & 63);
+        break;
+      case 213:
+      case 214:
+      case 215:          // Scroll_NorthWest_xxx
+        dsvars->source = dsvars->source + (scrollOffset
+                                  << (pl->special - 213) & 63) +
+            ((scrollOffset << (pl->special - 213) & 63) << 6);
+        break;
+      case 216:
+      case 217:
+      case 218:          // Scroll_NorthEast_xxx
+        dsvars->source = dsvars->source + ((63 - scrollOffset)
+                                  << (pl->special - 216) & 63) +
+            ((scrollOffset << (pl->special - 216) & 63) << 6);
+        break;
+      case 219:
+      case 220:
+      case 221:          // Scroll_SouthEast_xxx
+        dsvars->source = dsvars->source + ((63 - scrollOffset)
+                                  << (pl->special - 219) & 63) +
+            (((63 - scrollOffset) << (pl->special - 219) & 63) << 6);
+        break;
+      case 222:
+      case 223:
+      case 224:          // Scroll_SouthWest_xxx
+        dsvars->source = dsvars->source + (scrollOffset
+                                  << (pl->special - 222) & 63) +
+            (((63 - scrollOffset) << (pl->special - 222) & 63) << 6);
+        break;
+      default:
+        break;
+    }
+  }
+  else if (heretic)
+  {
+    switch (pl->special)
+    {
+      case 20:
+      case 21:
+      case 22:
+      case 23:
+      case 24:           // Scroll_East
+        dsvars->source = dsvars->source +
+          ((63 - ((leveltime >> 1) & 63)) << (pl->special - 20) & 63);
+        break;
+      case 4:            // Scroll_EastLavaDamage
+        dsvars->source = dsvars->source +
+          (((63 - ((leveltime >> 1) & 63)) << 3) & 63);
+        break;
+    }
+  }
+
+  dsvars->planeheight = D_abs(pl->height-viewz);
+
+  // SoM 10/19/02: deep water colormap fix
+  if(fixedcolormap)
+    light = (255  >> LIGHTSEGSHIFT);
+  else
+    light = (pl->lightlevel >> LIGHTSEGSHIFT) + (extralight * LIGHTBRIGHT);
+
+  if(light >= LIGHTLEVELS)
+    light = LIGHTLEVELS-1;
+
+  if(light < 0)
+    light = 0;
+
+  dsvars->planezlight = zlight[light];
+  pl->top[pl->minx-1] = pl->top[pl->maxx+1] = SHRT_MAX; // dropoff overflow
+}
+
+// Clips a plane column to rows y0..y1, empty columns become SHRT_MAX / 0
+
+static void R_ClipPlaneColumn(unsigned int *t, unsigned int *b, int y0, int y1)
+{
+  if (*t == SHRT_MAX)
+    return;
+
+  if (*t < (unsigned int) y0)
+    *t = y0;
+  if (*b > (unsigned int) y1)
+    *b = y1;
+
+  if (*t > *b)
+  {
+    *t = SHRT_MAX;
+    *b = 0;
+  }
+}
+
+// Draws the spans of a flat that lie in rows y0..y1.
+// Rows are independent, so disjoint row ranges can be drawn in parallel.
+
+static void R_DrawFlatPlaneRows(visplane_t *pl, const draw_span_vars_t *base, int y0, int y1)
+{
+  int x;
+  int stop = pl->maxx + 1;
+  draw_span_vars_t dsvars = *base;
+  unsigned int t1, b1, t2, b2;
+
+  t2 = pl->top[pl->minx-1];
+  b2 = pl->bottom[pl->minx-1];
+  R_ClipPlaneColumn(&t2, &b2, y0, y1);
+
+  for (x = pl->minx ; x <= stop ; x++)
+  {
+    t1 = t2;
+    b1 = b2;
+    t2 = pl->top[x];
+    b2 = pl->bottom[x];
+    R_ClipPlaneColumn(&t2, &b2, y0, y1);
+    R_MakeSpans(x, t1, b1, t2, b2, &dsvars);
+  }
+}
+
 // New function, by Lee Killough
 
 static void R_DoDrawPlane(visplane_t *pl)
@@ -630,156 +897,124 @@ static void R_DoDrawPlane(visplane_t *pl)
         }
     }
     else {     // regular flat
-
-      int stop, light;
       draw_span_vars_t dsvars;
 
-      dsvars.source = W_LumpByNum(firstflat + flattranslation[pl->picnum]);
-      dsvars.xoffs = pl->xoffs;
-      dsvars.yoffs = pl->yoffs;
-      dsvars.xscale = pl->xscale;
-      dsvars.yscale = pl->yscale;
-
-      if (pl->rotation)
-      {
-        fixed_t rotation_cos, rotation_sin;
-
-        rotation_cos = finecosine[pl->rotation >> ANGLETOFINESHIFT];
-        rotation_sin = finesine[pl->rotation >> ANGLETOFINESHIFT];
+      R_SetupFlatPlane(pl, &dsvars);
+      R_DrawFlatPlaneRows(pl, &dsvars, 0, viewheight - 1);
+    }
+  }
+}
 
-        dsvars.xoffs += FixedMul(rotation_cos, viewx) - FixedMul(rotation_sin, viewy);
-        dsvars.yoffs -= FixedMul(rotation_sin, viewx) + FixedMul(rotation_cos, viewy);
-        dsvars.sine = finesine[(viewangle + pl->rotation) >> ANGLETOFINESHIFT];
-        dsvars.cosine = finecosine[(viewangle + pl->rotation) >> ANGLETOFINESHIFT];
-      }
-      else
-      {
-        dsvars.xoffs += viewx;
-        dsvars.yoffs -= viewy;
-        dsvars.sine = viewsin;
-        dsvars.cosine = viewcos;
-      }
+//
+// RDrawPlanes
+// At the end of each frame.
+//
 
-      if (map_format.hexen)
-      {
-        int scrollOffset = leveltime >> 1 & 63;
-
-        switch (pl->special)
-        {                       // Handle scrolling flats
-          case 201:
-          case 202:
-          case 203:          // Scroll_North_xxx
-            dsvars.source = dsvars.source + ((scrollOffset
-                                       << (pl->special - 201) & 63) << 6);
-            break;
-          case 204:
-          case 205:
-          case 206:          // Scroll_East_xxx
-            dsvars.source = dsvars.source + ((63 - scrollOffset)
-                                      << (pl->special - 204) & 63);
-            break;
-          case 207:
-          case 208:
-          case 209:          // Scroll_South_xxx
-            dsvars.source = dsvars.source + (((63 - scrollOffset)
-                                       << (pl->special - 207) & 63) << 6);
-            break;
-          case 210:
-          case 211:
-          case 212:          // Scroll_West_xxx
-            dsvars.source = dsvars.source + (scrollOffset
-                                      << (pl->special - 210) & 63);
-            break;
-          case 213:
-          case 214:
-          case 215:          // Scroll_NorthWest_xxx
-            dsvars.source = dsvars.source + (scrollOffset
-                                      << (pl->special - 213) & 63) +
-                ((scrollOffset << (pl->special - 213) & 63) << 6);
-            break;
-          case 216:
-          case 217:
-          case 218:          // Scroll_NorthEast_xxx
-            dsvars.source = dsvars.source + ((63 - scrollOffset)
-                                      << (pl->special - 216) & 63) +
-                ((scrollOffset << (pl->special - 216) & 63) << 6);
-            break;
-          case 219:
-          case 220:
-          case 221:          // Scroll_SouthEast_xxx
-            dsvars.source = dsvars.source + ((63 - scrollOffset)
-                                      << (pl->special - 219) & 63) +
-                (((63 - scrollOffset) << (pl->special - 219) & 63) << 6);
-            break;
-          case 222:
-          case 223:
-          case 224:          // Scroll_SouthWest_xxx
-            dsvars.source = dsvars.source + (scrollOffset
-                                      << (pl->special - 222) & 63) +
-                (((63 - scrollOffset) << (pl->special - 222) & 63) << 6);
-            break;
-          default:
-            break;
-        }
-      }
-      else if (heretic)
-      {
-        switch (pl->special)
-        {
-          case 20:
-          case 21:
-          case 22:
-          case 23:
-          case 24:           // Scroll_East
-            dsvars.source = dsvars.source +
-              ((63 - ((leveltime >> 1) & 63)) << (pl->special - 20) & 63);
-            break;
-          case 4:            // Scroll_EastLavaDamage
-            dsvars.source = dsvars.source +
-              (((63 - ((leveltime >> 1) & 63)) << 3) & 63);
-            break;
-        }
-      }
+// Flats handed to the render threads, see R_DrawPlanes
+typedef struct
+{
+  visplane_t *pl;
+  draw_span_vars_t dsvars;
+  int miny, maxy;
+} flat_job_t;
 
-      dsvars.planeheight = D_abs(pl->height-viewz);
+static flat_job_t *flat_jobs;
+static int num_flat_jobs;
+static int max_flat_jobs;
 
-      // SoM 10/19/02: deep water colormap fix
-      if(fixedcolormap)
-        light = (255  >> LIGHTSEGSHIFT);
-      else
-        light = (pl->lightlevel >> LIGHTSEGSHIFT) + (extralight * LIGHTBRIGHT);
+// Each thread takes every count-th band, so the cheap rows near the
+// horizon and the expensive ones near the bottom are shared evenly
+#define FLAT_BANDS_PER_THREAD 4
 
-      if(light >= LIGHTLEVELS)
-        light = LIGHTLEVELS-1;
+static void R_DrawFlatJobs(int index, int count, void *data)
+{
+  int bands = count * FLAT_BANDS_PER_THREAD;
+  int band_height = (viewheight + bands - 1) / bands;
+  int band, i;
 
-      if(light < 0)
-        light = 0;
+  for (band = index; band < bands; band += count)
+  {
+    int y0 = band * band_height;
+    int y1 = MIN(y0 + band_height, viewheight) - 1;
 
-      stop = pl->maxx + 1;
-      dsvars.planezlight = zlight[light];
-      pl->top[pl->minx-1] = pl->top[stop] = SHRT_MAX; // dropoff overflow
+    for (i = 0; i < num_flat_jobs; i++)
+    {
+      flat_job_t *job = &flat_jobs[i];
 
-      for (x = pl->minx ; x <= stop ; x++)
-         R_MakeSpans(x,pl->top[x-1],pl->bottom[x-1],
-                     pl->top[x],pl->bottom[x], &dsvars);
+      if (job->miny <= y1 && job->maxy >= y0)
+        R_DrawFlatPlaneRows(job->pl, &job->dsvars, y0, y1);
     }
   }
 }
 
-//
-// RDrawPlanes
-// At the end of each frame.
-//
+static void R_AddFlatJob(visplane_t *pl)
+{
+  flat_job_t *job;
+  int x;
+
+  if (num_flat_jobs == max_flat_jobs)
+  {
+    max_flat_jobs = max_flat_jobs ? max_flat_jobs * 2 : 128;
+    flat_jobs = Z_Realloc(flat_jobs, max_flat_jobs * sizeof(*flat_jobs));
+  }
+
+  job = &flat_jobs[num_flat_jobs++];
+  job->pl = pl;
+  job->miny = viewheight;
+  job->maxy = -1;
+
+  R_SetupFlatPlane(pl, &job->dsvars);
+
+  for (x = pl->minx; x <= pl->maxx; x++)
+    if (pl->top[x] != SHRT_MAX && pl->top[x] <= pl->bottom[x])
+    {
+      job->miny = MIN(job->miny, pl->top[x]);
+      job->maxy = MAX(job->maxy, pl->bottom[x]);
+    }
+}
 
 void R_DrawPlanes (void)
 {
   visplane_t *pl;
   int i;
-  for (i=0;i<MAXVISPLANES;i++)
-    for (pl=visplanes[i]; pl; pl=pl->next)
+
+  // Visplanes never share pixels, so flats are drawn by the render threads
+  // in row bands while the main thread draws the skies
+  if (V_IsSoftwareMode() && R_RenderThreadCount() > 1)
+  {
+    num_flat_jobs = 0;
+
+    for (i = 0; i < num_visplanes; i++)
+    {
+      pl = visplanes[i];
+
+      if (pl->minx <= pl->maxx && pl->picnum != skyflatnum && !(pl->picnum & PL_SKYFLAT))
+        R_AddFlatJob(pl);
+    }
+
+    R_StartRenderJobs(R_DrawFlatJobs, NULL);
+
+    for (i = 0; i < num_visplanes; i++)
     {
+      pl = visplanes[i];
+
       dsda_RecordVisPlane();
 
-      R_DoDrawPlane(pl);
+      if (pl->picnum == skyflatnum || pl->picnum & PL_SKYFLAT)
+        R_DoDrawPlane(pl);
     }
+
+    R_FinishRenderJobs();
+
+    return;
+  }
+
+  for (i = 0; i < num_visplanes; i++)
+  {
+    pl = visplanes[i];
+
+    dsda_RecordVisPlane();
+
+    R_DoDrawPlane(pl);
+  }
 }
@@ -85,8 +85,14 @@ typedef struct drawsegs_xrange_s
   int count;
 } drawsegs_xrange_t;
 
+// Whole view, left half and right half, followed by one range
+// for each DS_TILE_WIDTH column tile
 #define DS_RANGES_COUNT 3
-static drawsegs_xrange_t drawsegs_xranges[DS_RANGES_COUNT];
+#define DS_TILE_SHIFT 6
+#define DS_TILE_WIDTH (1 << DS_TILE_SHIFT)
+#define DS_TILE(x) ((x) >> DS_TILE_SHIFT)
+static drawsegs_xrange_t *drawsegs_xranges;
+static int drawsegs_xranges_count;
 
 static drawseg_xrange_item_t *drawsegs_xrange;
 static unsigned int drawsegs_xrange_size = 0;
@@ -898,10 +904,7 @@ static void R_ProjectSprite (mobj_t* thing, int lightlevel)
     vis->colormap = fullcolormap;     // full bright  // killough 3/20/98
   else
     {      // diminished light
-      int index = (int)(((int64_t)xscale * 160 / wide_centerx) >> LIGHTSCALESHIFT);
-      if (index >= MAXLIGHTSCALE)
-        index = MAXLIGHTSCALE - 1;
-      vis->colormap = spritelights[index];
+      vis->colormap = spritelights[R_LightScaleIndex(xscale)];
     }
 
   R_UpdateVisSpriteTranMap(vis, thing);
@@ -1299,62 +1302,113 @@ void R_DrawPlayerSprites(void)
 // Rewritten by Lee Killough to avoid using unnecessary
 // linked lists, and to use faster sorting algorithm.
 //
+// Sprites are ordered with a stable radix sort on the scale. Sprites at
+// the same distance keep the order killough's merge sort gave them, see
+// R_VisSpriteTieOrder.
+//
 
-#ifdef DJGPP
-
-// killough 9/22/98: inlined memcpy of pointer arrays
-// CPhipps - added memory as modified
-#define bcopyp(d, s, n) asm(" cld; rep; movsl;" :: "D"(d), "S"(s), "c"(n) : "%cc", "%esi", "%edi", "%ecx", "memory")
+static unsigned int *vissprite_keys, *vissprite_order;
 
-#else
+// Writes the vissprite indices of positions first..first+n-1 of the old
+// merge sort's input (vissprite total-1 first) in the order that, once
+// stably sorted and reversed, puts equal scales where the merge sort did:
+// runs under 16 were insertion sorted in place, and each merge took the
+// second half before the first on a tie.
+static unsigned int *R_VisSpriteTieOrder(unsigned int *out, int first, int n, int total)
+{
+  if (n >= 16)
+  {
+    int n1 = n / 2;
 
-#define bcopyp(d, s, n) memcpy(d, s, (n) * sizeof(void *))
+    out = R_VisSpriteTieOrder(out, first, n1, total);
+    return R_VisSpriteTieOrder(out, first + n1, n - n1, total);
+  }
+  else
+  {
+    int p;
 
-#endif
+    for (p = first + n - 1; p >= first; p--)
+      *out++ = total - 1 - p;
 
-// killough 9/2/98: merge sort
+    return out;
+  }
+}
 
-static void msort(vissprite_t **s, vissprite_t **t, int n)
+// Sorts the first n of vissprite_order by vissprite_keys, smallest first.
+// keys and order are followed by n spare entries used as scratch.
+static void R_RadixSortVisSprites(int n)
 {
-  if (n >= 16)
+  unsigned int *keys = vissprite_keys, *order = vissprite_order;
+  unsigned int *tmp_keys = keys + n, *tmp_order = order + n;
+  int shift;
+
+  if (n < 32)
+  {
+    int i;
+
+    for (i = 1; i < n; i++)
     {
-      int n1 = n/2, n2 = n - n1;
-      vissprite_t **s1 = s, **s2 = s + n1, **d = t;
+      unsigned int key = keys[i], index = order[i];
+      int j = i;
 
-      msort(s1, t, n1);
-      msort(s2, t, n2);
+      for (; j > 0 && keys[j - 1] > key; j--)
+      {
+        keys[j] = keys[j - 1];
+        order[j] = order[j - 1];
+      }
 
-      while ((*s1)->scale > (*s2)->scale ?
-             (*d++ = *s1++, --n1) : (*d++ = *s2++, --n2));
+      keys[j] = key;
+      order[j] = index;
+    }
 
-      if (n2)
-        bcopyp(d, s2, n2);
-      else
-        bcopyp(d, s1, n1);
+    return;
+  }
+
+  for (shift = 0; shift < 32; shift += 8)
+  {
+    int count[256] = { 0 };
+    int i, sum;
+
+    for (i = 0; i < n; i++)
+      count[(keys[i] >> shift) & 0xff]++;
+
+    // All keys share this digit, nothing to move
+    if (count[(keys[0] >> shift) & 0xff] == n)
+      continue;
+
+    for (i = 0, sum = 0; i < 256; i++)
+    {
+      int c = count[i];
 
-      bcopyp(s, t, n);
+      count[i] = sum;
+      sum += c;
     }
-  else
+
+    for (i = 0; i < n; i++)
     {
-      int i;
-      for (i = 1; i < n; i++)
-        {
-          vissprite_t *temp = s[i];
-          if (s[i-1]->scale < temp->scale)
-            {
-              int j = i;
-              while ((s[j] = s[j-1])->scale < temp->scale && --j);
-              s[j] = temp;
-            }
-        }
+      int d = count[(keys[i] >> shift) & 0xff]++;
+
+      tmp_keys[d] = keys[i];
+      tmp_order[d] = order[i];
     }
+
+    {
+      unsigned int *t;
+
+      t = keys; keys = tmp_keys; tmp_keys = t;
+      t = order; order = tmp_order; tmp_order = t;
+    }
+  }
+
+  if (order != vissprite_order)
+    memcpy(vissprite_order, order, n * sizeof(*order));
 }
 
 void R_SortVisSprites (void)
 {
   if (num_vissprite)
     {
-      int i = num_vissprite;
+      int i;
 
       // If we need to allocate more pointers for the vissprites,
       // allocate as many as were allocated for sprites -- killough
@@ -1363,17 +1417,25 @@ void R_SortVisSprites (void)
       if (num_vissprite_ptrs < num_vissprite*2)
         {
           Z_Free(vissprite_ptrs);  // better than realloc -- no preserving needed
-          vissprite_ptrs = Z_Malloc((num_vissprite_ptrs = num_vissprite_alloc*2)
-                                  * sizeof *vissprite_ptrs);
+          Z_Free(vissprite_keys);
+          Z_Free(vissprite_order);
+          num_vissprite_ptrs = num_vissprite_alloc*2;
+          vissprite_ptrs = Z_Malloc(num_vissprite_ptrs * sizeof *vissprite_ptrs);
+          vissprite_keys = Z_Malloc(num_vissprite_ptrs * sizeof *vissprite_keys);
+          vissprite_order = Z_Malloc(num_vissprite_ptrs * sizeof *vissprite_order);
         }
 
-      while (--i>=0)
-        vissprite_ptrs[num_vissprite-i-1] = vissprites+i;
+      R_VisSpriteTieOrder(vissprite_order, 0, num_vissprite, num_vissprite);
+
+      // Flipping the sign bit makes signed scales sort as unsigned keys
+      for (i = 0; i < num_vissprite; i++)
+        vissprite_keys[i] = (unsigned int) vissprites[vissprite_order[i]].scale ^ 0x80000000u;
 
-      // killough 9/22/98: replace qsort with merge sort, since the keys
-      // are roughly in order to begin with, due to BSP rendering.
+      R_RadixSortVisSprites(num_vissprite);
 
-      msort(vissprite_ptrs, vissprite_ptrs + num_vissprite, num_vissprite);
+      // Largest scale first, R_DrawMasked walks the list backwards
+      for (i = 0; i < num_vissprite; i++)
+        vissprite_ptrs[num_vissprite-i-1] = vissprites + vissprite_order[i];
     }
 }
 
@@ -1524,6 +1586,7 @@ void R_DrawMasked(void)
   int i;
   drawseg_t *ds;
   int cx = SCREENWIDTH / 2;
+  int ranges_count = DS_RANGES_COUNT + DS_TILE(MAX(viewwidth, 1) - 1) + 1;
 
   R_SortVisSprites();
 
@@ -1531,15 +1594,23 @@ void R_DrawMasked(void)
   // Reducing of cache misses in the following R_DrawSprite()
   // Makes sense for scenes with huge amount of drawsegs.
   // ~12% of speed improvement on epic.wad map05
-  for(i = 0; i < DS_RANGES_COUNT; i++)
+  for(i = 0; i < drawsegs_xranges_count; i++)
     drawsegs_xranges[i].count = 0;
 
   if (num_vissprite > 0)
   {
-    if (drawsegs_xrange_size < maxdrawsegs)
+    if (drawsegs_xrange_size < maxdrawsegs || drawsegs_xranges_count < ranges_count)
     {
-      drawsegs_xrange_size = 2 * maxdrawsegs;
-      for(i = 0; i < DS_RANGES_COUNT; i++)
+      if (drawsegs_xranges_count < ranges_count)
+      {
+        drawsegs_xranges = Z_Realloc(drawsegs_xranges, ranges_count * sizeof(*drawsegs_xranges));
+        memset(drawsegs_xranges + drawsegs_xranges_count, 0,
+               (ranges_count - drawsegs_xranges_count) * sizeof(*drawsegs_xranges));
+        drawsegs_xranges_count = ranges_count;
+      }
+
+      drawsegs_xrange_size = MAX(drawsegs_xrange_size, 2 * maxdrawsegs);
+      for(i = 0; i < drawsegs_xranges_count; i++)
       {
         drawsegs_xranges[i].items = Z_Realloc(
           drawsegs_xranges[i].items,
@@ -1550,6 +1621,8 @@ void R_DrawMasked(void)
     {
       if (ds->silhouette || ds->maskedtexturecol)
       {
+        int tile;
+
         drawsegs_xranges[0].items[drawsegs_xranges[0].count].x1 = ds->x1;
         drawsegs_xranges[0].items[drawsegs_xranges[0].count].x2 = ds->x2;
         drawsegs_xranges[0].items[drawsegs_xranges[0].count].user = ds;
@@ -1568,6 +1641,14 @@ void R_DrawMasked(void)
           drawsegs_xranges[2].count++;
         }
 
+        // Narrow sprites only need the drawsegs touching their tile
+        for (tile = DS_TILE(ds->x1); tile <= DS_TILE(ds->x2); tile++)
+        {
+          drawsegs_xrange_t *range = &drawsegs_xranges[DS_RANGES_COUNT + tile];
+
+          range->items[range->count++] = drawsegs_xranges[0].items[drawsegs_xranges[0].count];
+        }
+
         drawsegs_xranges[0].count++;
       }
     }
@@ -1581,7 +1662,14 @@ void R_DrawMasked(void)
   {
     vissprite_t* spr = vissprite_ptrs[i];
 
-    if (spr->x2 < cx)
+    if (DS_TILE(spr->x1) == DS_TILE(spr->x2))
+    {
+      drawsegs_xrange_t *range = &drawsegs_xranges[DS_RANGES_COUNT + DS_TILE(spr->x1)];
+
+      drawsegs_xrange = range->items;
+      drawsegs_xrange_count = range->count;
+    }
+    else if (spr->x2 < cx)
     {
       drawsegs_xrange = drawsegs_xranges[1].items;
       drawsegs_xrange_count = drawsegs_xranges[1].count;
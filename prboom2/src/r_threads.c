@@ -0,0 +1,214 @@
+/* Emacs style mode select   -*- C -*-
+ *-----------------------------------------------------------------------------
+ *
+ *
+ *  PrBoom: a Doom port merged with LxDoom and LSDLDoom
+ *  based on BOOM, a modified and improved DOOM engine
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License
+ *  as published by the Free Software Foundation; either version 2
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+ *  02111-1307, USA.
+ *
+ * DESCRIPTION:
+ *      Worker threads for the software renderer.
+ *      A fixed pool of render_threads - 1 threads picks up job slices,
+ *      the thread that started the jobs runs slice 0 itself.
+ *
+ *---------------------------------------------------------------------
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "SDL.h"
+#include "SDL_thread.h"
+
+#include "doomtype.h"
+#include "i_system.h"
+#include "lprintf.h"
+#include "z_zone.h"
+#include "r_threads.h"
+
+#include "dsda/configuration.h"
+
+#define MAX_RENDER_THREADS 64
+
+static SDL_mutex *render_mutex;
+static SDL_cond *render_start_cond;
+static SDL_cond *render_done_cond;
+static SDL_Thread *render_threads[MAX_RENDER_THREADS];
+static int render_thread_count = 1;
+
+static render_job_f render_job;
+static void *render_job_data;
+static int render_job_generation;
+static int render_jobs_left;
+static dboolean render_jobs_running;
+static dboolean render_threads_quit;
+
+// Pool size that failed to start, not retried until the setting changes
+static int render_threads_failed;
+
+typedef struct
+{
+  int index;
+} render_thread_arg_t;
+
+static render_thread_arg_t render_thread_args[MAX_RENDER_THREADS];
+
+static int R_RenderThread(void *arg)
+{
+  int index = ((render_thread_arg_t *) arg)->index;
+  int generation = 0;
+
+  SDL_LockMutex(render_mutex);
+
+  while (1)
+  {
+    while (render_job_generation == generation && !render_threads_quit)
+      SDL_CondWait(render_start_cond, render_mutex);
+
+    if (render_threads_quit)
+      break;
+
+    generation = render_job_generation;
+
+    SDL_UnlockMutex(render_mutex);
+    render_job(index, render_thread_count, render_job_data);
+    SDL_LockMutex(render_mutex);
+
+    if (!--render_jobs_left)
+      SDL_CondSignal(render_done_cond);
+  }
+
+  SDL_UnlockMutex(render_mutex);
+
+  return 0;
+}
+
+static void R_StopRenderThreads(void)
+{
+  int i, s;
+
+  if (render_thread_count <= 1)
+    return;
+
+  SDL_LockMutex(render_mutex);
+  render_threads_quit = true;
+  SDL_CondBroadcast(render_start_cond);
+  SDL_UnlockMutex(render_mutex);
+
+  for (i = 1; i < render_thread_count; i++)
+    SDL_WaitThread(render_threads[i], &s);
+
+  render_thread_count = 1;
+  render_threads_quit = false;
+}
+
+static void R_ShutdownRenderThreads(void)
+{
+  R_StopRenderThreads();
+}
+
+static void R_StartRenderThreads(int count)
+{
+  int i;
+
+  if (!render_mutex)
+  {
+    render_mutex = SDL_CreateMutex();
+    render_start_cond = SDL_CreateCond();
+    render_done_cond = SDL_CreateCond();
+
+    I_AtExit(R_ShutdownRenderThreads, true, "R_ShutdownRenderThreads", exit_priority_normal);
+  }
+
+  if (!render_mutex || !render_start_cond || !render_done_cond)
+  {
+    lprintf(LO_WARN, "R_StartRenderThreads: no thread primitives, drawing single-threaded\n");
+    render_threads_failed = count;
+    return;
+  }
+
+  render_job_generation = 0;
+
+  for (i = 1; i < count; i++)
+  {
+    render_thread_args[i].index = i;
+    render_threads[i] = SDL_CreateThread(R_RenderThread, "R_RenderThread", &render_thread_args[i]);
+
+    if (!render_threads[i])
+    {
+      lprintf(LO_WARN, "R_StartRenderThreads: only %d of %d threads started, drawing single-threaded\n",
+              i, count);
+      R_StopRenderThreads();
+      render_threads_failed = count;
+      return;
+    }
+
+    render_thread_count = i + 1;
+  }
+}
+
+int R_RenderThreadCount(void)
+{
+  int count = BETWEEN(1, MAX_RENDER_THREADS, dsda_IntConfig(dsda_config_render_threads));
+
+  if (count == render_threads_failed)
+    count = 1;
+
+  // The pool only changes size between frames
+  if (!render_jobs_running && count != render_thread_count)
+  {
+    R_StopRenderThreads();
+    R_StartRenderThreads(count);
+  }
+
+  return render_thread_count;
+}
+
+void R_StartRenderJobs(render_job_f job, void *data)
+{
+  render_job = job;
+  render_job_data = data;
+  render_jobs_running = true;
+
+  if (render_thread_count <= 1)
+    return;
+
+  SDL_LockMutex(render_mutex);
+  render_jobs_left = render_thread_count - 1;
+  render_job_generation++;
+  SDL_CondBroadcast(render_start_cond);
+  SDL_UnlockMutex(render_mutex);
+}
+
+void R_FinishRenderJobs(void)
+{
+  if (!render_jobs_running)
+    return;
+
+  render_job(0, render_thread_count, render_job_data);
+
+  if (render_thread_count > 1)
+  {
+    SDL_LockMutex(render_mutex);
+    while (render_jobs_left)
+      SDL_CondWait(render_done_cond, render_mutex);
+    SDL_UnlockMutex(render_mutex);
+  }
+
+  render_jobs_running = false;
+}
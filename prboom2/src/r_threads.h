@@ -0,0 +1,45 @@
+/* Emacs style mode select   -*- C -*-
+ *-----------------------------------------------------------------------------
+ *
+ *
+ *  PrBoom: a Doom port merged with LxDoom and LSDLDoom
+ *  based on BOOM, a modified and improved DOOM engine
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License
+ *  as published by the Free Software Foundation; either version 2
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+ *  02111-1307, USA.
+ *
+ * DESCRIPTION:
+ *      Worker threads for the software renderer
+ *
+ *---------------------------------------------------------------------
+ */
+
+#ifndef __R_THREADS__
+#define __R_THREADS__
+
+// Runs job(0..count-1, data), see R_StartRenderJobs
+typedef void (*render_job_f)(int index, int count, void *data);
+
+// Number of job slices to split work into, 1 when threading is off
+int R_RenderThreadCount(void);
+
+// Starts slices 1..count-1 on the worker threads and returns right away.
+// Job functions must not allocate zone memory or touch shared renderer state.
+void R_StartRenderJobs(render_job_f job, void *data);
+
+// Runs slice 0 on the calling thread and waits for the workers to finish
+void R_FinishRenderJobs(void);
+
+#endif